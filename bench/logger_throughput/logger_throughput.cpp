@@ -0,0 +1,57 @@
+#include <facade/util/logger.hpp>
+#include <fmt/format.h>
+#include <chrono>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+using namespace facade;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::uint32_t thread_count_v{8};
+
+double seconds_since(Clock::time_point const start) { return std::chrono::duration<double>(Clock::now() - start).count(); }
+
+// thread_count_v threads logging count messages each: logging returns once the entry is queued for the file sink
+void concurrent(std::uint64_t const count) {
+	auto instance = std::optional<logger::Instance>{std::in_place};
+	// the console sink dominates otherwise (and floods the terminal)
+	logger::set_level(logger::Sink::eConsole, logger::Level::eWarn);
+	auto const start = Clock::now();
+	{
+		auto threads = std::vector<std::jthread>{};
+		for (std::uint32_t i = 0; i < thread_count_v; ++i) {
+			threads.emplace_back([i, count] {
+				for (std::uint64_t message = 0; message < count; ++message) { logger::info("[Bench] thread: [{}] message: [{}]", i, message); }
+			});
+		}
+	}
+	auto const logged = seconds_since(start);
+	// destroying the instance drains the file logger
+	instance.reset();
+	auto const drained = seconds_since(start);
+	auto const total = static_cast<double>(count * thread_count_v);
+	fmt::print("{} threads x {} messages: logged: [{:.2f} M msgs/s] written: [{:.2f} M msgs/s]\n", thread_count_v, count, total / logged / 1e6,
+			   total / drained / 1e6);
+}
+
+// messages below every sink's level: the cost of a disabled log call
+void filtered(std::uint64_t const count) {
+	auto const instance = logger::Instance{};
+	for (auto const sink : {logger::Sink::eConsole, logger::Sink::eFile, logger::Sink::eBuffer}) { logger::set_level(sink, logger::Level::eWarn); }
+	auto const start = Clock::now();
+	for (std::uint64_t message = 0; message < count; ++message) { logger::info("[Bench] filtered message: [{}]", message); }
+	fmt::print("filtered: [{:.2f} ns/call]\n", seconds_since(start) * 1e9 / static_cast<double>(count));
+}
+} // namespace
+
+// usage: bench-logger-throughput [messages per thread]
+// writes facade.log to the working directory (each logger instance rotates the previous one to facade.log.bak)
+int main(int argc, char** argv) {
+	auto const count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50'000ull;
+	concurrent(count);
+	filtered(count * 100);
+}
@@ -0,0 +1,62 @@
+#include <facade/util/async_queue.hpp>
+#include <facade/util/ring_queue.hpp>
+#include <fmt/format.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+using namespace facade;
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+	std::uint32_t producers{};
+	std::uint32_t consumers{};
+};
+
+constexpr Config configs_v[] = {{1, 1}, {2, 2}, {4, 4}, {8, 2}, {2, 8}, {8, 8}};
+
+// producers push count items each through blocking push, consumers drain through blocking pop until all items are consumed
+template <typename Queue>
+double items_per_second(Queue& queue, Config const config, std::uint64_t const count) {
+	auto const total = count * config.producers;
+	auto consumed = std::atomic<std::uint64_t>{};
+	auto const start = Clock::now();
+	auto consumers = std::vector<std::jthread>{};
+	for (std::uint32_t i = 0; i < config.consumers; ++i) {
+		consumers.emplace_back([&](std::stop_token const& stop) {
+			while (!stop.stop_requested()) {
+				if (queue.pop(stop)) { ++consumed; }
+			}
+		});
+	}
+	auto producers = std::vector<std::jthread>{};
+	for (std::uint32_t i = 0; i < config.producers; ++i) {
+		producers.emplace_back([&queue, count] {
+			for (std::uint64_t item = 0; item < count; ++item) { queue.push(item); }
+		});
+	}
+	while (consumed.load() < total) { std::this_thread::yield(); }
+	auto const elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+	for (auto& consumer : consumers) { consumer.request_stop(); }
+	queue.ping();
+	return static_cast<double>(total) / elapsed;
+}
+} // namespace
+
+// usage: bench-queue-contention [items per producer] [ring capacity]
+int main(int argc, char** argv) {
+	auto const count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000ull;
+	auto const capacity = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024ull;
+	fmt::print("{:>10} {:>10} {:>14} {:>14}\n", "producers", "consumers", "AsyncQueue", "RingQueue");
+	for (auto const config : configs_v) {
+		auto async_queue = AsyncQueue<std::uint64_t>{};
+		auto ring_queue = RingQueue<std::uint64_t>{capacity};
+		auto const async_rate = items_per_second(async_queue, config, count);
+		auto const ring_rate = items_per_second(ring_queue, config, count);
+		fmt::print("{:>10} {:>10} {:>10.2f} M/s {:>10.2f} M/s\n", config.producers, config.consumers, async_rate / 1e6, ring_rate / 1e6);
+	}
+}
@@ -0,0 +1,103 @@
+#include <facade/util/thread_pool.hpp>
+#include <fmt/format.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// counts every allocation in the process: the pool's own bookkeeping (deque blocks, promise state) included
+namespace {
+std::atomic<std::uint64_t> g_allocations{};
+}
+
+void* operator new(std::size_t size) {
+	++g_allocations;
+	if (void* ret = std::malloc(size)) { return ret; }
+	throw std::bad_alloc{};
+}
+
+// GCC assumes the argument of a replaced operator delete came from the default operator new, and flags free() as mismatched
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+using namespace facade;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::uint64_t task_count_v{1'000'000};
+
+struct Sample {
+	double tasks_per_second{};
+	double allocations_per_task{};
+};
+
+template <typename F>
+Sample measure(std::uint64_t const count, F func) {
+	auto const allocations = g_allocations.load();
+	auto const start = Clock::now();
+	func();
+	auto const elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+	return Sample{static_cast<double>(count) / elapsed, static_cast<double>(g_allocations.load() - allocations) / static_cast<double>(count)};
+}
+
+void print(std::string_view name, Sample const& sample) {
+	fmt::print("{:<32} {:>8.2f} M tasks/s {:>6.2f} allocs/task\n", name, sample.tasks_per_second / 1e6, sample.allocations_per_task);
+}
+
+// construct and invoke UniqueTasks on the calling thread: isolates the type erasure cost
+Sample store_invoke() {
+	auto tasks = std::vector<UniqueTask<void()>>{};
+	tasks.reserve(task_count_v);
+	auto sum = std::uint64_t{};
+	auto ret = measure(task_count_v, [&] {
+		for (std::uint64_t i = 0; i < task_count_v; ++i) { tasks.push_back([&sum, i] { sum += i; }); }
+		for (auto& task : tasks) { task(); }
+	});
+	if (sum != task_count_v * (task_count_v - 1) / 2) { fmt::print(stderr, "store_invoke: invalid sum [{}]\n", sum); }
+	return ret;
+}
+
+// fire and forget: one UniqueTask per task
+Sample post(ThreadPool& pool) {
+	auto done = std::atomic<std::uint64_t>{};
+	return measure(task_count_v, [&] {
+		for (std::uint64_t i = 0; i < task_count_v; ++i) { pool.post([&done] { ++done; }); }
+		while (done.load() < task_count_v) { std::this_thread::yield(); }
+	});
+}
+
+// promise / future per task
+Sample enqueue(ThreadPool& pool) {
+	static constexpr auto count_v = task_count_v / 10;
+	auto futures = std::vector<std::future<void>>{};
+	futures.reserve(count_v);
+	auto done = std::atomic<std::uint64_t>{};
+	return measure(count_v, [&] {
+		for (std::uint64_t i = 0; i < count_v; ++i) { futures.push_back(pool.enqueue([&done] { ++done; })); }
+		for (auto const& future : futures) { future.wait(); }
+	});
+}
+} // namespace
+
+// usage: bench-task-throughput [threads] (defaults to hardware concurrency)
+int main(int argc, char** argv) {
+	auto const threads = argc > 1 ? static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10)) : std::thread::hardware_concurrency();
+	print("UniqueTask store + invoke", store_invoke());
+	auto thread_counts = std::vector<std::uint32_t>{1};
+	if (threads > 1) { thread_counts.push_back(threads); }
+	for (auto const count : thread_counts) {
+		auto pool = ThreadPool{count};
+		print(fmt::format("ThreadPool::post ({} threads)", count), post(pool));
+		print(fmt::format("ThreadPool::enqueue ({} threads)", count), enqueue(pool));
+	}
+}
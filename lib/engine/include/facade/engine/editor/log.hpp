@@ -10,8 +10,14 @@ struct LogState {
 	int display_count{50};
 	bool auto_scroll{true};
 
-	std::vector<logger::Entry const*> list{};
+	// indices of filtered entries in the log buffer: reused across frames
+	std::vector<std::size_t> list{};
 };
 
+///
+/// \brief Display the log buffer.
+///
+/// Entries are read in place, while the log buffer is locked.
+///
 void display_log(NotClosed<Window> window, LogState& out_state);
 } // namespace facade::editor
@@ -2,6 +2,7 @@
 #include <facade/build_version.hpp>
 #include <facade/engine/stats.hpp>
 #include <facade/glfw/glfw.hpp>
+#include <facade/scene/load_options.hpp>
 #include <facade/scene/load_status.hpp>
 #include <facade/scene/scene.hpp>
 #include <facade/util/time.hpp>
@@ -22,6 +23,11 @@ struct EngineCreateInfo {
 	bool auto_show{false};
 	Validation validation{Validation::eDefault};
 	std::optional<std::uint32_t> force_thread_count{};
+	LoadOptions load_options{};
+	///
+	/// \brief Memory budget for textures in bytes (unlimited if 0); only streamed textures are evicted.
+	///
+	std::uint64_t texture_budget{};
 };
 
 ///
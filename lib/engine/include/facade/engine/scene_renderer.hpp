@@ -2,34 +2,51 @@
 #include <facade/render/renderer.hpp>
 #include <facade/scene/scene.hpp>
 #include <facade/vk/buffer.hpp>
+#include <facade/vk/meshlet.hpp>
+#include <optional>
 
 namespace facade {
 class Skybox;
+class ThreadPool;
 
 class SceneRenderer {
   public:
 	struct Info {
 		std::uint32_t triangles_drawn{};
 		std::uint32_t draw_calls{};
+		std::uint32_t meshlets_culled{};
 	};
 
+	///
+	/// \brief Estimated on-screen size (in pixels) of each texture drawn in the last frame.
+	///
+	using TextureSizes = std::unordered_map<Id<Texture>, float, std::hash<std::size_t>>;
+
 	explicit SceneRenderer(Gfx const& gfx);
 
 	Info const& info() const { return m_info; }
-	void render(Scene const& scene, Ptr<Skybox const> skybox, Renderer& renderer, vk::CommandBuffer cb);
+	TextureSizes const& texture_sizes() const { return m_texture_sizes; }
+	///
+	/// \brief Record draw calls for a scene.
+	/// \param thread_pool Optional pointer to thread pool to compute instance matrices on (at high priority)
+	///
+	void render(Scene const& scene, Ptr<Skybox const> skybox, Renderer& renderer, vk::CommandBuffer cb, ThreadPool* thread_pool = {});
 
   private:
 	void write_view(glm::vec2 const extent);
 	void update_view(Pipeline& out_pipeline) const;
+	void write_instance_mats(std::vector<glm::mat4x4>& out_mats, std::span<Transform const> instances, glm::mat4x4 const& parent) const;
 	BufferView make_instance_mats(std::span<Transform const> instances, glm::mat4x4 const& parent);
 	DescriptorBuffer make_joint_mats(Skin const& skin, glm::mat4x4 const& parent);
 	glm::mat4x4 compute_global_mat(Node const& node) const;
 	glm::mat4x4 const& get_global_mat(Node const& node);
+	void add_texture_sizes(Material const& material, std::span<glm::mat4x4 const> mats);
 
 	void render(Renderer& renderer, vk::CommandBuffer cb, Skybox const& skybox);
 	void render(Renderer& renderer, vk::CommandBuffer cb, Node const& node, glm::mat4x4 parent = matrix_identity_v);
 	void draw(Renderer& renderer, vk::CommandBuffer cb, Node const& node, Mesh::Primitive const& primitive);
 	void draw(vk::CommandBuffer cb, MeshPrimitive const& mesh, BufferView instances);
+	void draw(vk::CommandBuffer cb, MeshPrimitive const& mesh, BufferView instances, std::span<glm::mat4x4 const> mats);
 
 	Gfx m_gfx;
 	Material m_material;
@@ -42,7 +59,14 @@ class SceneRenderer {
 	Texture m_black;
 	Info m_info{};
 	std::unordered_map<Id<Node>, glm::mat4x4, std::hash<std::size_t>> m_global_mats{};
+	std::optional<MeshletCuller> m_culler{};
+	std::vector<glm::mat4x4> m_instance_mats{};
+	std::vector<IndexRange> m_ranges{};
+	TextureSizes m_texture_sizes{};
+	glm::mat4x4 m_mat_vp{};
+	float m_pixel_scale{};
 
 	Scene const* m_scene{};
+	ThreadPool* m_thread_pool{};
 };
 } // namespace facade
@@ -22,6 +22,21 @@ struct Stats {
 	///
 	std::uint32_t draw_calls{};
 
+	///
+	/// \brief Meshlets culled in previous frame.
+	///
+	std::uint32_t meshlets_culled{};
+
+	///
+	/// \brief Textures with mip levels yet to be streamed in.
+	///
+	std::size_t textures_streaming{};
+
+	///
+	/// \brief GPU memory used by scene textures.
+	///
+	vk::DeviceSize texture_memory{};
+
 	///
 	/// \brief Framerate (until previous frame).
 	///
@@ -0,0 +1,78 @@
+#pragma once
+#include <facade/engine/scene_renderer.hpp>
+#include <facade/util/thread_pool.hpp>
+#include <future>
+
+namespace facade {
+///
+/// \brief Manages residency of streaming textures: streams in mip levels prioritized by on-screen size,
+/// and evicts them least recently used first to stay within a memory budget.
+///
+/// Textures drawn largest relative to their resident resolution are streamed first, those not drawn at all last.
+/// Only textures not drawn in the previous frame are evicted; they stream back in from their sources once drawn again.
+///
+class TextureStreamer {
+  public:
+	struct Info {
+		///
+		/// \brief Textures that can stream in more detailed mip levels.
+		///
+		std::size_t streaming{};
+		///
+		/// \brief GPU memory used by all textures.
+		///
+		vk::DeviceSize memory{};
+		///
+		/// \brief Mip levels scheduled for eviction.
+		///
+		std::uint32_t evicted{};
+	};
+
+	///
+	/// \brief Construct an instance.
+	/// \param budget Texture memory budget in bytes (unlimited if 0)
+	/// \param max_uploads Maximum number of concurrent uploads
+	///
+	explicit TextureStreamer(vk::DeviceSize budget = {}, std::uint32_t max_uploads = 2) : m_budget(budget), m_max_uploads(max_uploads) {}
+
+	vk::DeviceSize budget() const { return m_budget; }
+	void set_budget(vk::DeviceSize budget) { m_budget = budget; }
+
+	///
+	/// \brief Swap in rebuilt images, schedule evictions if over budget, and schedule further uploads.
+	/// \param textures Textures to manage
+	/// \param sizes On-screen sizes of textures drawn in the previous frame
+	/// \param thread_pool ThreadPool to upload on (one level is uploaded on the calling thread if it has no workers)
+	/// \returns Residency info
+	///
+	/// Must be called on the render thread, before the scene is rendered.
+	///
+	Info update(std::span<Texture> textures, SceneRenderer::TextureSizes const& sizes, ThreadPool& thread_pool);
+	///
+	/// \brief Wait for in-flight uploads and discard usage history.
+	///
+	/// Must be called before the managed textures are replaced (eg on scene load): indices refer to different textures after.
+	///
+	void reset();
+
+  private:
+	struct Candidate {
+		std::size_t index{};
+		float priority{};
+	};
+
+	std::uint32_t evict(std::span<Texture> textures, ThreadPool& thread_pool);
+	std::uint32_t stream(std::span<Texture> textures, SceneRenderer::TextureSizes const& sizes, ThreadPool& thread_pool);
+	bool over_budget(vk::DeviceSize growth) const { return m_budget > 0 && m_projected + growth > m_budget; }
+	void run(UniqueTask<void()> task, ThreadPool& thread_pool);
+
+	std::vector<std::future<void>> m_uploads{};
+	std::vector<Candidate> m_candidates{};
+	std::vector<Candidate> m_lru{};
+	std::vector<std::uint64_t> m_last_used{};
+	std::uint64_t m_frame{};
+	vk::DeviceSize m_projected{};
+	vk::DeviceSize m_budget{};
+	std::uint32_t m_max_uploads{};
+};
+} // namespace facade
@@ -55,6 +55,7 @@ void ResourceInspector::view(Texture const& texture, Id<Texture> id) const {
 		TreeNode::leaf(FixedString{"Mip levels: {}", texture.mip_levels()}.c_str());
 		auto const cs = texture.colour_space() == ColourSpace::eLinear ? "linear" : "sRGB";
 		TreeNode::leaf(FixedString{"Colour Space: {}", cs}.c_str());
+		if (texture.streaming()) { TreeNode::leaf("Streaming"); }
 	}
 }
 
@@ -66,6 +67,7 @@ void ResourceInspector::view(MeshPrimitive const& mesh, Id<MeshPrimitive> id) co
 		auto const info = mesh.info();
 		ImGui::Text("%s", FixedString{"Vertices: {}", info.vertices}.c_str());
 		ImGui::Text("%s", FixedString{"Indices: {}", info.indices}.c_str());
+		if (info.indices > 0) { ImGui::Text("%s", FixedString{"Index type: {}", info.index_type == vk::IndexType::eUint16 ? "u16" : "u32"}.c_str()); }
 	}
 }
 
@@ -4,12 +4,47 @@
 #include <facade/util/fixed_string.hpp>
 
 namespace facade {
+namespace {
+struct DisplayEntries : logger::Accessor {
+	editor::NotClosed<editor::Window> window;
+	editor::LogState& out_state;
+
+	DisplayEntries(editor::NotClosed<editor::Window> window, editor::LogState& out_state) : window(window), out_state(out_state) {}
+
+	void operator()(logger::BufferView const& entries) final {
+		out_state.list.clear();
+		for (std::size_t i = 0; i < entries.size(); ++i) {
+			if (out_state.level_filter[entries[i].level]) { out_state.list.push_back(i); }
+		}
+		if (entries.dropped > 0) { ImGui::TextDisabled("%s", FixedString{"({} older entries dropped)", entries.dropped}.c_str()); }
+		auto child = editor::Window{window, "scroll", {}, {}, ImGuiWindowFlags_HorizontalScrollbar};
+		static constexpr auto im_colour = [](logger::Level const l) {
+			switch (l) {
+			case logger::Level::eError: return ImVec4{1.0f, 0.0f, 0.0f, 1.0f};
+			case logger::Level::eWarn: return ImVec4{1.0f, 1.0f, 0.0f, 1.0f};
+			default:
+			case logger::Level::eInfo: return ImVec4{1.0f, 1.0f, 1.0f, 1.0f};
+			case logger::Level::eDebug: return ImVec4{0.5f, 0.5f, 0.5f, 1.0f};
+			}
+		};
+		auto span = std::span{out_state.list};
+		auto const max_size = static_cast<std::size_t>(out_state.display_count);
+		if (span.size() > max_size) { span = span.subspan(span.size() - max_size); }
+		if (auto style = editor::StyleVar{ImGuiStyleVar_ItemSpacing, glm::vec2{}}) {
+			for (auto const index : span) { ImGui::TextColored(im_colour(entries[index].level), "%s", entries[index].c_str()); }
+		}
+
+		if (out_state.auto_scroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) { ImGui::SetScrollHereY(1.0f); }
+	}
+};
+} // namespace
+
 void editor::display_log(NotClosed<Window> window, LogState& out_state) {
 	ImGui::Text("%s", FixedString{"Count: {}", out_state.display_count}.c_str());
 	ImGui::SameLine();
 	float spacing = ImGui::GetStyle().ItemInnerSpacing.x;
 	ImGui::PushButtonRepeat(true);
-	auto const max_logs = static_cast<int>(logger::buffer_size().total());
+	auto const max_logs = static_cast<int>(logger::buffer_size().capacity);
 	if (ImGui::ArrowButton("##left", ImGuiDir_Left)) { out_state.display_count = std::clamp(out_state.display_count - 10, 0, max_logs); }
 	ImGui::SameLine(0.0f, spacing);
 	if (ImGui::ArrowButton("##right", ImGuiDir_Right)) { out_state.display_count = std::clamp(out_state.display_count + 10, 0, max_logs); }
@@ -27,23 +62,7 @@ void editor::display_log(NotClosed<Window> window, LogState& out_state) {
 	ImGui::Checkbox("Auto-scroll", &out_state.auto_scroll);
 
 	ImGui::Separator();
-	auto child = editor::Window{window, "scroll", {}, {}, ImGuiWindowFlags_HorizontalScrollbar};
-	static constexpr auto im_colour = [](logger::Level const l) {
-		switch (l) {
-		case logger::Level::eError: return ImVec4{1.0f, 0.0f, 0.0f, 1.0f};
-		case logger::Level::eWarn: return ImVec4{1.0f, 1.0f, 0.0f, 1.0f};
-		default:
-		case logger::Level::eInfo: return ImVec4{1.0f, 1.0f, 1.0f, 1.0f};
-		case logger::Level::eDebug: return ImVec4{0.5f, 0.5f, 0.5f, 1.0f};
-		}
-	};
-	auto span = std::span{out_state.list};
-	auto const max_size = static_cast<std::size_t>(out_state.display_count);
-	if (span.size() > max_size) { span = span.subspan(span.size() - max_size); }
-	if (auto style = editor::StyleVar{ImGuiStyleVar_ItemSpacing, glm::vec2{}}) {
-		for (auto const* entry : span) ImGui::TextColored(im_colour(entry->level), "%s", entry->message.c_str());
-	}
-
-	if (out_state.auto_scroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) { ImGui::SetScrollHereY(1.0f); }
+	auto display = DisplayEntries{window, out_state};
+	logger::access_buffer(display);
 }
 } // namespace facade
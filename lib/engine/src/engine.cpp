@@ -5,14 +5,19 @@
 #include <facade/defines.hpp>
 #include <facade/engine/engine.hpp>
 #include <facade/engine/scene_renderer.hpp>
+#include <facade/engine/texture_streamer.hpp>
 #include <facade/glfw/glfw_wsi.hpp>
 #include <facade/render/renderer.hpp>
+#include <facade/scene/cooked_loader.hpp>
+#include <facade/scene/cooked_scene.hpp>
+#include <facade/scene/glb.hpp>
 #include <facade/scene/gltf_loader.hpp>
 #include <facade/util/data_provider.hpp>
 #include <facade/util/enumerate.hpp>
 #include <facade/util/env.hpp>
 #include <facade/util/error.hpp>
 #include <facade/util/logger.hpp>
+#include <facade/util/pack_file.hpp>
 #include <facade/util/thread_pool.hpp>
 #include <facade/util/zip_ranges.hpp>
 #include <facade/vk/cmd.hpp>
@@ -163,10 +168,44 @@ struct RenderWindow {
 		  renderer(gfx, this->window, gui.get(), Renderer::CreateInfo{command_buffers_v, msaa}), gui(std::move(gui)) {}
 };
 
-bool load_gltf(Scene& out_scene, char const* path, AtomicLoadStatus& out_status, ThreadPool* thread_pool) {
+// cooked scenes are stale if missing, or cooked from different sources / options (any modification time changed)
+bool is_stale(char const* cooked, std::uint64_t source_stamp) { return CookedScene::read_stamp(cooked) != source_stamp; }
+
+bool load_json(Scene& out_scene, char const* path, dj::Json const& json, DataProvider const& provider, AtomicLoadStatus& out_status, ThreadPool* thread_pool,
+			   LoadOptions const& options) {
+	if (options.cook_scenes) {
+		auto const cooked = fs::path{path}.replace_extension(CookedScene::extension_v).string();
+		auto const stamp = Scene::GltfLoader::source_stamp(path, json, options);
+		if (!is_stale(cooked.c_str(), stamp) || Scene::GltfLoader::cook(cooked.c_str(), json, provider, options, thread_pool, stamp)) {
+			if (Scene::CookedLoader{out_scene, out_status, options}(cooked.c_str(), thread_pool)) { return true; }
+			logger::warn("[Engine] Failed to load cooked scene, falling back to GLTF: [{}]", path);
+		}
+	}
+	return Scene::GltfLoader{out_scene, out_status, options}(json, provider, thread_pool);
+}
+
+bool load_gltf(Scene& out_scene, char const* path, AtomicLoadStatus& out_status, ThreadPool* thread_pool, LoadOptions const& options) {
+	auto const extension = fs::path{path}.extension();
+	if (extension == CookedScene::extension_v) { return Scene::CookedLoader{out_scene, out_status, options}(path, thread_pool); }
+	if (extension == PackFile::extension_v) {
+		auto const provider = PackDataProvider{path, thread_pool};
+		if (!provider || provider.pack().root().empty()) {
+			logger::error("[Engine] Pack file has no root GLTF: [{}]", path);
+			return false;
+		}
+		auto const root = provider.view(provider.pack().root());
+		auto json = dj::Json::parse(std::string_view{reinterpret_cast<char const*>(root.bytes().data()), root.bytes().size()});
+		return Scene::GltfLoader{out_scene, out_status, options}(json, provider, thread_pool);
+	}
+	if (extension == GlbDataProvider::extension_v) {
+		auto const provider = GlbDataProvider{path};
+		if (!provider) { return false; }
+		return load_json(out_scene, path, provider.json(), provider, out_status, thread_pool, options);
+	}
 	auto const provider = FileDataProvider::mount_parent_dir(path);
 	auto json = dj::Json::from_file(path);
-	return Scene::GltfLoader{out_scene, out_status}(json, provider, thread_pool);
+	if (extension != ".gltf") { return Scene::GltfLoader{out_scene, out_status, options}(json, provider, thread_pool); }
+	return load_json(out_scene, path, json, provider, out_status, thread_pool, options);
 }
 
 std::optional<Skybox::Data> load_skybox_data(char const* path, AtomicLoadStatus& out_status, ThreadPool* thread_pool) {
@@ -178,7 +217,8 @@ std::optional<Skybox::Data> load_skybox_data(char const* path, AtomicLoadStatus&
 
 	auto const provider = FileDataProvider::mount_parent_dir(path);
 	auto load_image = [&provider, &out_status, thread_pool](std::string_view uri) {
-		auto load = [&provider, uri] { return Image{provider.load(uri).span(), std::string{uri}}; };
+		// decoded straight from the file mapping
+		auto load = [&provider, uri] { return Image{provider.view(uri).bytes(), std::string{uri}}; };
 		if (thread_pool) {
 			return LoadFuture<Image>{*thread_pool, out_status.done, load};
 		} else {
@@ -249,8 +289,10 @@ struct Engine::Impl {
 	Skybox skybox;
 
 	std::uint8_t msaa;
+	LoadOptions load_options;
 
 	ThreadPool thread_pool{};
+	TextureStreamer streamer{};
 	std::mutex mutex{};
 	Stats stats{};
 	Fps fps{};
@@ -262,9 +304,11 @@ struct Engine::Impl {
 		bool active() const { return request.scene.valid() || request.skybox_data.valid(); }
 	} load{};
 
-	Impl(UniqueWin window, std::uint8_t msaa, bool validation, std::optional<std::uint32_t> thread_count)
+	Impl(UniqueWin window, std::uint8_t msaa, bool validation, std::optional<std::uint32_t> thread_count, LoadOptions const& load_options,
+		 std::uint64_t texture_budget)
 		: window(std::move(window), std::make_unique<DearImGui>(), msaa, validation), renderer(this->window.gfx), scene(this->window.gfx),
-		  skybox(this->window.gfx), msaa(msaa), thread_pool(thread_count) {
+		  skybox(this->window.gfx), msaa(msaa), load_options(load_options),
+		  thread_pool(ThreadPool::CreateInfo{.thread_count = thread_count, .name = "facade-load"}), streamer(texture_budget) {
 		s_instance = this;
 		load.request.status.reset();
 	}
@@ -287,7 +331,8 @@ bool Engine::is_instance_active() { return s_instance != nullptr; }
 Engine::Engine(CreateInfo const& info) noexcept(false) {
 	if (s_instance) { throw Error{"Engine: active instance exists and has not been destroyed"}; }
 	if (info.force_thread_count) { logger::info("[Engine] Forcing load thread count: [{}]", *info.force_thread_count); }
-	m_impl = std::make_unique<Impl>(make_window(info.extent, info.title), info.desired_msaa, determine_validation(info.validation), info.force_thread_count);
+	m_impl = std::make_unique<Impl>(make_window(info.extent, info.title), info.desired_msaa, determine_validation(info.validation), info.force_thread_count,
+									info.load_options, info.texture_budget);
 	if (info.auto_show) { show(true); }
 }
 
@@ -309,7 +354,7 @@ auto Engine::poll() -> State const& {
 	m_impl->window.gui->new_frame();
 	m_impl->window.window.get().glfw->poll_events();
 	auto const& ret = m_impl.get()->window.window.get().state();
-	m_impl->scene.tick(ret.dt);
+	m_impl->scene.tick(ret.dt, &m_impl->thread_pool);
 	m_impl->stats.fps = m_impl->fps.next_frame();
 	++m_impl->stats.frame_counter;
 	return ret;
@@ -317,14 +362,20 @@ auto Engine::poll() -> State const& {
 
 void Engine::render() {
 	auto cb = vk::CommandBuffer{};
+	// swap in streamed mip levels before any descriptors are written this frame
+	auto& textures = m_impl->scene.resources().textures;
+	auto const residency = m_impl->streamer.update(textures.view(), m_impl->renderer.texture_sizes(), m_impl->thread_pool);
+	m_impl->stats.textures_streaming = residency.streaming;
+	m_impl->stats.texture_memory = residency.memory;
 	// we skip rendering the scene if acquiring a swapchain image fails (unlikely)
-	if (m_impl->window.renderer.next_frame({&cb, 1})) { m_impl->renderer.render(scene(), &m_impl->skybox, renderer(), cb); }
+	if (m_impl->window.renderer.next_frame({&cb, 1})) { m_impl->renderer.render(scene(), &m_impl->skybox, renderer(), cb, &m_impl->thread_pool); }
 	m_impl->window.gui->end_frame();
 	m_impl->window.renderer.render();
 	{
 		auto const& info = m_impl->renderer.info();
 		m_impl->stats.draw_calls = info.draw_calls;
 		m_impl->stats.triangles = info.triangles_drawn;
+		m_impl->stats.meshlets_culled = info.meshlets_culled;
 	}
 	{
 		auto info = m_impl->window.renderer.info();
@@ -358,9 +409,10 @@ bool Engine::load_async(std::string json_path, UniqueTask<void()> on_loaded) {
 		};
 
 		m_impl->scene.lights = {};
+		m_impl->streamer.reset();
 
 		auto const start = time::since_start();
-		if (load_gltf(m_impl->scene, json_path.c_str(), m_impl->load.request.status, nullptr)) {
+		if (load_gltf(m_impl->scene, json_path.c_str(), m_impl->load.request.status, nullptr, m_impl->load_options)) {
 			logger::info("...GLTF [{}] loaded in [{:.2f}s]", env::to_filename(json_path), time::since_start() - start);
 			return early_ret();
 		}
@@ -389,21 +441,22 @@ bool Engine::load_async(std::string json_path, UniqueTask<void()> on_loaded) {
 	m_impl->load.request.path = std::move(json_path);
 	m_impl->load.request.status.reset();
 	m_impl->load.request.start_time = time::since_start();
-	// if thread pool queue has only one worker thread, can't dispatch tasks from within a task and then wait for them (deadlock)
-	auto* tp = m_impl->thread_pool.thread_count() > 1 ? &m_impl->thread_pool : nullptr;
+	// loading tasks dispatch nested tasks and wait on them: workers run queued tasks while waiting, even with one thread
+	// nested tasks inherit the low priority of the load: frame work enqueued meanwhile runs first
+	auto* tp = &m_impl->thread_pool;
 	if (type == "Skybox") {
 		auto func = [path = m_impl->load.request.path, status = &m_impl->load.request.status, tp] { return load_skybox_data(path.c_str(), *status, tp); };
 		// store future
-		m_impl->load.request.skybox_data = m_impl->thread_pool.enqueue(func);
+		m_impl->load.request.skybox_data = m_impl->thread_pool.enqueue(func, ThreadPool::Priority::eLow);
 	} else {
-		auto func = [path = m_impl->load.request.path, gfx = m_impl->window.gfx, status = &m_impl->load.request.status, tp] {
+		auto func = [path = m_impl->load.request.path, gfx = m_impl->window.gfx, status = &m_impl->load.request.status, tp, options = m_impl->load_options] {
 			auto scene = Scene{gfx};
-			if (!load_gltf(scene, path.c_str(), *status, tp)) { logger::error("[Engine] Failed to load GLTF: [{}]", path); }
+			if (!load_gltf(scene, path.c_str(), *status, tp, options)) { logger::error("[Engine] Failed to load GLTF: [{}]", path); }
 			// return the scene even on failure, it will be empty but valid
 			return scene;
 		};
 		// store future
-		m_impl->load.request.scene = m_impl->thread_pool.enqueue(func);
+		m_impl->load.request.scene = m_impl->thread_pool.enqueue(func, ThreadPool::Priority::eLow);
 	}
 	return true;
 }
@@ -426,7 +479,8 @@ void Engine::update_load_request() {
 	auto lock = std::unique_lock{m_impl->mutex};
 	// early return if future isn't valid or is still busy
 	if (ready(m_impl->load.request.scene)) {
-		// transfer scene (under mutex lock)
+		// transfer scene (under mutex lock): streamed indices refer to the outgoing textures until then
+		m_impl->streamer.reset();
 		m_impl->scene = m_impl->load.request.scene.get();
 		// reset load status
 		m_impl->load.request.status.reset();
@@ -1,12 +1,18 @@
 #include <facade/engine/scene_renderer.hpp>
 #include <facade/util/error.hpp>
+#include <facade/util/parallel.hpp>
 #include <facade/util/zip_ranges.hpp>
 #include <facade/vk/skybox.hpp>
+#include <glm/geometric.hpp>
+#include <algorithm>
 
 namespace facade {
 namespace {
 using Bmp1x1 = FixedBitmap<1, 1>;
 
+// a matrix product per instance: only large instance counts are worth spreading across the pool
+constexpr std::size_t instance_grain_v{1024};
+
 struct DirLightSSBO {
 	alignas(16) glm::vec3 direction{front_v};
 	alignas(16) glm::vec3 ambient{0.04f};
@@ -39,10 +45,12 @@ SceneRenderer::SceneRenderer(Gfx const& gfx)
 	  m_white(gfx, m_sampler.sampler(), Bmp1x1{0xff_B, 0xff_B, 0xff_B, 0xff_B}.view(), Texture::CreateInfo{.mip_mapped = false}),
 	  m_black(gfx, m_sampler.sampler(), Bmp1x1{0x0_B, 0x0_B, 0x0_B, 0xff_B}.view(), Texture::CreateInfo{.mip_mapped = false}) {}
 
-void SceneRenderer::render(Scene const& scene, Ptr<Skybox const> skybox, Renderer& renderer, vk::CommandBuffer cb) {
+void SceneRenderer::render(Scene const& scene, Ptr<Skybox const> skybox, Renderer& renderer, vk::CommandBuffer cb, ThreadPool* thread_pool) {
 	m_scene = &scene;
+	m_thread_pool = thread_pool;
 	m_info = {};
 	m_global_mats.clear();
+	m_texture_sizes.clear();
 	write_view(renderer.framebuffer_extent());
 	if (skybox) { render(renderer, cb, *skybox); }
 	for (auto const& node : m_scene->roots()) { render(renderer, cb, m_scene->resources().nodes[node]); }
@@ -55,13 +63,24 @@ void SceneRenderer::write_view(glm::vec2 const extent) {
 	auto const cam_id = cam_node.find<Camera>();
 	assert(cam_id);
 	auto const& cam = m_scene->resources().cameras[*cam_id];
+	auto const mat_v = cam.view(cam_node.transform);
+	auto const mat_p = cam.projection(extent);
+	m_mat_vp = mat_p * mat_v;
+	// an object of unit size at clip space w = 1 covers this many pixels vertically
+	m_pixel_scale = extent.y * mat_p[1][1];
+	m_culler.reset();
+	if (m_scene->render_mode.frustum_cull) {
+		// normal cones are tested against the camera position, which is meaningless for orthographic views
+		bool const backface = m_scene->render_mode.backface_cull && std::holds_alternative<Camera::Perspective>(cam.type);
+		m_culler.emplace(m_mat_vp, cam_node.transform.position(), backface);
+	}
 	struct ViewSSBO {
 		glm::mat4x4 mat_v;
 		glm::mat4x4 mat_p;
 		glm::vec4 vpos_exposure;
 	} view{
-		.mat_v = cam.view(cam_node.transform),
-		.mat_p = cam.projection(extent),
+		.mat_v = mat_v,
+		.mat_p = mat_p,
 		.vpos_exposure = {cam_node.transform.position(), cam.exposure},
 	};
 	m_view_proj.write<ViewSSBO>({&view, 1});
@@ -77,15 +96,19 @@ void SceneRenderer::update_view(Pipeline& out_pipeline) const {
 	out_pipeline.bind(set0);
 }
 
+void SceneRenderer::write_instance_mats(std::vector<glm::mat4x4>& out_mats, std::span<Transform const> instances, glm::mat4x4 const& parent) const {
+	if (instances.empty()) {
+		out_mats.push_back(parent);
+		return;
+	}
+	out_mats.resize(instances.size());
+	parallel_for(
+		m_thread_pool, instances.size(), instance_grain_v, [&](std::size_t index) { out_mats[index] = parent * instances[index].matrix(); },
+		ThreadPool::Priority::eHigh);
+}
+
 BufferView SceneRenderer::make_instance_mats(std::span<Transform const> instances, glm::mat4x4 const& parent) {
-	auto rewrite = [&](std::vector<glm::mat4x4>& mats) {
-		if (instances.empty()) {
-			mats.push_back(parent);
-		} else {
-			mats.reserve(instances.size());
-			for (auto const& transform : instances) { mats.push_back(parent * transform.matrix()); }
-		}
-	};
+	auto rewrite = [&](std::vector<glm::mat4x4>& mats) { write_instance_mats(mats, instances, parent); };
 	return m_instances.rewrite(m_gfx, instances.empty() ? 1u : instances.size(), rewrite).view();
 }
 
@@ -112,6 +135,32 @@ glm::mat4 const& SceneRenderer::get_global_mat(Node const& node) {
 	return it->second;
 }
 
+void SceneRenderer::add_texture_sizes(Material const& material, std::span<glm::mat4x4 const> mats) {
+	auto const textures = material.textures();
+	auto const& resources = m_scene->resources().textures;
+	auto const is_streamed = [&resources](Id<Texture> id) {
+		auto const* texture = resources.find(id);
+		return texture && texture->streamed();
+	};
+	// sizes only drive streaming / eviction: skip projecting instances if no texture here is streamed
+	if (std::none_of(textures.span().begin(), textures.span().end(), is_streamed)) { return; }
+	// meshes are assumed to be roughly unit sized in local space: project the scaled origin of each instance
+	auto const project = [&](glm::mat4x4 const& model) {
+		auto const w = (m_mat_vp * model[3]).w;
+		if (w <= 0.0f) { return 0.0f; }
+		auto const scale = std::max({glm::length(glm::vec3{model[0]}), glm::length(glm::vec3{model[1]}), glm::length(glm::vec3{model[2]})});
+		return m_pixel_scale * scale / w;
+	};
+	auto const size = parallel_reduce(
+		m_thread_pool, mats.size(), instance_grain_v, 0.0f, [&](std::size_t index) { return project(mats[index]); },
+		[](float a, float b) { return std::max(a, b); }, ThreadPool::Priority::eHigh);
+	for (auto const id : textures.span()) {
+		if (!is_streamed(id)) { continue; }
+		auto& texture_size = m_texture_sizes[id];
+		texture_size = std::max(texture_size, size);
+	}
+}
+
 void SceneRenderer::render(Renderer& renderer, vk::CommandBuffer cb, Skybox const& skybox) {
 	auto const& vlayout = skybox.mesh().vertex_layout();
 	auto pipeline = renderer.bind_pipeline(cb, vlayout, {.depth_test = false}, "skybox.frag");
@@ -133,6 +182,10 @@ void SceneRenderer::render(Renderer& renderer, vk::CommandBuffer cb, Node const&
 	auto const store = TextureStore{resources.textures, m_white, m_black};
 	parent = parent * node.transform.matrix();
 	if (auto mesh_id = node.find<Mesh>()) {
+		// computed once per node: projected for texture sizes, uploaded as instance data, and reused for culling
+		m_instance_mats.clear();
+		write_instance_mats(m_instance_mats, node.instances, parent);
+		auto instances = BufferView{};
 		auto const& mesh = resources.meshes[*mesh_id];
 		for (auto const& primitive : mesh.primitives) {
 			auto const state = Pipeline::State{
@@ -146,14 +199,23 @@ void SceneRenderer::render(Renderer& renderer, vk::CommandBuffer cb, Node const&
 			pipeline.set_line_width(m_scene->render_mode.line_width);
 			update_view(pipeline);
 			material.write_sets(pipeline, store);
+			add_texture_sizes(material, m_instance_mats);
 
 			if (mesh_primitive.has_joints()) {
 				auto& set3 = pipeline.next_set(3);
 				set3.update(0, make_joint_mats(resources.skins[*node.find<Skin>()], parent));
 				pipeline.bind(set3);
 				draw(cb, mesh_primitive, {});
+				continue;
+			}
+			if (!instances.buffer) {
+				auto const upload = [this](std::vector<glm::mat4x4>& mats) { mats.assign(m_instance_mats.begin(), m_instance_mats.end()); };
+				instances = m_instances.rewrite(m_gfx, m_instance_mats.size(), upload).view();
+			}
+			if (m_culler && !mesh_primitive.meshlets().empty()) {
+				draw(cb, mesh_primitive, instances, m_instance_mats);
 			} else {
-				draw(cb, mesh_primitive, make_instance_mats(node.instances, parent));
+				draw(cb, mesh_primitive, instances);
 			}
 		}
 	}
@@ -168,7 +230,19 @@ void SceneRenderer::draw(vk::CommandBuffer cb, MeshPrimitive const& mesh, Buffer
 	} else {
 		mesh.draw(cb, 1u);
 	}
-	m_info.triangles_drawn += mesh.info().vertices / 3;
+	auto const info = mesh.info();
+	m_info.triangles_drawn += (info.indices > 0 ? info.indices : info.vertices) / 3;
 	++m_info.draw_calls;
 }
+
+void SceneRenderer::draw(vk::CommandBuffer cb, MeshPrimitive const& mesh, BufferView instances, std::span<glm::mat4x4 const> mats) {
+	assert(m_culler && instances.buffer);
+	m_ranges.clear();
+	m_info.meshlets_culled += (*m_culler)(m_ranges, mesh.meshlets(), mats);
+	if (m_ranges.empty()) { return; }
+	cb.bindVertexBuffers(mesh.instance_binding(), instances.buffer, vk::DeviceSize{0});
+	mesh.draw(cb, m_ranges, instances.count);
+	for (auto const& range : m_ranges) { m_info.triangles_drawn += range.index_count / 3; }
+	m_info.draw_calls += static_cast<std::uint32_t>(m_ranges.size());
+}
 } // namespace facade
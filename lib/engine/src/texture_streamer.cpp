@@ -0,0 +1,101 @@
+#include <facade/engine/texture_streamer.hpp>
+#include <facade/util/enumerate.hpp>
+#include <algorithm>
+
+namespace facade {
+auto TextureStreamer::update(std::span<Texture> textures, SceneRenderer::TextureSizes const& sizes, ThreadPool& thread_pool) -> Info {
+	++m_frame;
+	std::erase_if(m_uploads, [](std::future<void> const& f) { return f.wait_for(std::chrono::seconds{}) == std::future_status::ready; });
+	// empty after reset()
+	if (textures.size() != m_last_used.size()) { m_last_used.assign(textures.size(), 0); }
+
+	auto ret = Info{};
+	for (auto [texture, index] : enumerate(textures)) {
+		texture.update_stream();
+		ret.memory += texture.memory();
+		if (sizes.contains(index)) { m_last_used[index] = m_frame; }
+		if (texture.streaming()) { ++ret.streaming; }
+	}
+
+	m_projected = ret.memory;
+	if (over_budget(0)) { ret.evicted += evict(textures, thread_pool); }
+	ret.evicted += stream(textures, sizes, thread_pool);
+	return ret;
+}
+
+void TextureStreamer::reset() {
+	for (auto const& upload : m_uploads) { upload.wait(); }
+	m_uploads.clear();
+	m_last_used.clear();
+	m_projected = {};
+}
+
+std::uint32_t TextureStreamer::evict(std::span<Texture> textures, ThreadPool& thread_pool) {
+	m_lru.clear();
+	for (auto [texture, index] : enumerate(textures)) {
+		if (texture.evictable_levels() == 0 || m_last_used[index] == m_frame) { continue; }
+		m_lru.push_back({index, static_cast<float>(m_frame - m_last_used[index])});
+	}
+	// ties (eg after reset()) are evicted in index order: eviction never depends on the previous scene or sort implementation
+	auto const older = [](Candidate const& a, Candidate const& b) { return a.priority > b.priority || (a.priority == b.priority && a.index < b.index); };
+	std::sort(m_lru.begin(), m_lru.end(), older);
+
+	auto ret = std::uint32_t{};
+	for (auto const& candidate : m_lru) {
+		if (!over_budget(0)) { break; }
+		auto& texture = textures[candidate.index];
+		// unused textures drop straight down to their smallest resident level
+		auto const levels = texture.evictable_levels();
+		auto task = texture.stream_to(texture.resident_level() + levels);
+		if (!task) { continue; }
+		// every level dropped quarters the size of a 2D mip chain
+		m_projected -= texture.memory() - (texture.memory() >> (2 * levels));
+		ret += levels;
+		run(std::move(task), thread_pool);
+	}
+	return ret;
+}
+
+std::uint32_t TextureStreamer::stream(std::span<Texture> textures, SceneRenderer::TextureSizes const& sizes, ThreadPool& thread_pool) {
+	auto ret = std::uint32_t{};
+	m_candidates.clear();
+	for (auto [texture, index] : enumerate(textures)) {
+		if (!texture.streaming()) { continue; }
+		auto const it = sizes.find(index);
+		auto const size = it == sizes.end() ? 0.0f : it->second;
+		auto const extent = texture.view().extent;
+		m_candidates.push_back({index, size / static_cast<float>(std::max(extent.width, extent.height))});
+	}
+	std::sort(m_candidates.begin(), m_candidates.end(), [](Candidate const& a, Candidate const& b) { return a.priority > b.priority; });
+
+	for (auto const& candidate : m_candidates) {
+		if (m_uploads.size() >= m_max_uploads) { break; }
+		auto& texture = textures[candidate.index];
+		// the next level is four times the size of the entire current chain
+		auto const growth = texture.memory() * 3;
+		if (over_budget(growth)) {
+			// only make room for textures that were drawn
+			if (candidate.priority <= 0.0f) { break; }
+			m_projected += growth;
+			ret += evict(textures, thread_pool);
+			m_projected -= growth;
+			if (over_budget(growth)) { continue; }
+		}
+		// empty if a task for this texture is still in flight
+		auto task = texture.stream_next();
+		if (!task) { continue; }
+		m_projected += growth;
+		run(std::move(task), thread_pool);
+		if (thread_pool.thread_count() == 0) { break; }
+	}
+	return ret;
+}
+
+void TextureStreamer::run(UniqueTask<void()> task, ThreadPool& thread_pool) {
+	if (thread_pool.thread_count() == 0) {
+		task();
+		return;
+	}
+	m_uploads.push_back(thread_pool.enqueue(std::move(task)));
+}
+} // namespace facade
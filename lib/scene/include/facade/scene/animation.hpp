@@ -7,6 +7,7 @@
 
 namespace facade {
 struct Node;
+class ThreadPool;
 
 MorphWeights lerp(MorphWeights const& a, MorphWeights const& b, float t);
 
@@ -16,20 +17,46 @@ struct Animator {
 	struct Scale : Interpolator<glm::vec3> {};
 	struct Morph : Interpolator<MorphWeights> {};
 
+	///
+	/// \brief Value of a channel at a point in time (std::monostate if none).
+	///
+	using Value = std::variant<std::monostate, glm::vec3, glm::quat, MorphWeights>;
+
 	std::variant<Translate, Rotate, Scale, Morph> channel{};
 	std::optional<Id<Node>> target{};
 
 	float duration() const;
-	void update(std::span<Node> nodes, float time) const;
+	///
+	/// \brief Sample the channel without modifying any nodes.
+	/// \param time Time to sample at
+	/// \returns Value of the channel (std::monostate if there is no target)
+	///
+	Value sample(float time) const;
+	///
+	/// \brief Write a sampled value to the target node.
+	/// \param nodes Nodes to index into
+	/// \param value Value obtained from sample()
+	///
+	void apply(std::span<Node> nodes, Value const& value) const;
+	void update(std::span<Node> nodes, float time) const { apply(nodes, sample(time)); }
 };
 
 class Animation {
   public:
 	void add(Animator animator);
-	void update(std::span<Node> nodes, float dt);
+	///
+	/// \brief Advance the animation and update target nodes.
+	/// \param nodes Nodes to index into
+	/// \param dt Duration to advance by
+	/// \param thread_pool Optional pointer to thread pool to sample channels on
+	///
+	/// Channels are sampled in parallel (if there are enough of them) and applied serially: multiple channels can target the same node.
+	///
+	void update(std::span<Node> nodes, float dt, ThreadPool* thread_pool = {});
 	bool enabled() const { return time_scale > 0.0f; }
 
 	float duration() const { return m_duration; }
+	std::span<Animator const> animators() const { return m_animators; }
 
 	std::string name{};
 	float time_scale{1.0f};
@@ -37,6 +64,7 @@ class Animation {
 
   private:
 	std::vector<Animator> m_animators{};
+	std::vector<Animator::Value> m_values{};
 	float m_duration{};
 };
 } // namespace facade
@@ -0,0 +1,39 @@
+#pragma once
+#include <facade/scene/gltf_loader.hpp>
+
+namespace facade {
+class Scene::CookedLoader {
+  public:
+	///
+	/// \brief Construct a CookedLoader.
+	/// \param out_scene The scene to load into
+	/// \param out_status AtomicLoadStatus to be updated as the scene is loaded
+	/// \param options Optional processing to apply to loaded data (only stream_textures is used)
+	///
+	CookedLoader(Scene& out_scene, AtomicLoadStatus& out_status, LoadOptions const& options = {})
+		: m_scene(out_scene), m_status(out_status), m_options(options) {
+		m_status.reset();
+	}
+
+	///
+	/// \brief Load a cooked scene file (see CookedScene).
+	/// \param path Path to the cooked scene file
+	/// \param thread_pool Optional pointer to thread pool to use for async uploading of textures and meshes
+	/// \returns true If successfully loaded
+	///
+	/// The file is memory mapped: payloads are uploaded from the mapping as-is, without any decoding or processing.
+	/// If the file fails to load, the scene data will remain unchanged.
+	/// This function purposely throws on fatal errors (including corrupt files).
+	///
+	bool operator()(char const* path, ThreadPool* thread_pool = {}) noexcept(false);
+	///
+	/// \brief Obtain the load status.
+	///
+	AtomicLoadStatus const& load_status() const { return m_status; }
+
+  private:
+	Scene& m_scene;
+	AtomicLoadStatus& m_status;
+	LoadOptions m_options;
+};
+} // namespace facade
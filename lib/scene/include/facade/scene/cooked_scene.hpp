@@ -0,0 +1,106 @@
+#pragma once
+#include <facade/scene/animation.hpp>
+#include <facade/scene/camera.hpp>
+#include <facade/scene/material.hpp>
+#include <facade/scene/mesh.hpp>
+#include <facade/scene/node_data.hpp>
+#include <facade/scene/skin.hpp>
+#include <facade/vk/mesh_primitive.hpp>
+#include <facade/vk/texture.hpp>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace facade {
+///
+/// \brief Pre-processed scene: tables followed by GPU-ready payloads, in page aligned sections of a single file.
+///
+/// Payloads are KTX2 images (with full mip chains) and packed vertex / index data (MeshPrimitive::Blob).
+/// They are views: into the file data when read, and into caller owned storage when written.
+/// Loading a cooked scene maps the file and uploads payloads as-is, skipping JSON parsing,
+/// accessor decoding, image decoding, mip generation, and mesh processing.
+///
+/// Tables store trivially copyable types verbatim: cooked scenes are caches, tied to the version that wrote them.
+///
+struct CookedScene {
+	///
+	/// \brief File extension of cooked scenes.
+	///
+	static constexpr std::string_view extension_v{".fcs"};
+
+	struct Texture {
+		std::string name{};
+		///
+		/// \brief Indices of images to use, in order of preference.
+		///
+		FlexArray<std::uint32_t, 2> images{};
+		std::optional<std::uint32_t> sampler{};
+		ColourSpace colour_space{ColourSpace::eSrgb};
+		bool mip_mapped{true};
+	};
+
+	struct Primitive {
+		std::string name{};
+		MeshPrimitive::Blob blob{};
+		std::vector<Meshlet> meshlets{};
+	};
+
+	struct Node {
+		NodeData data{};
+		MorphWeights weights{};
+	};
+
+	std::vector<Sampler::CreateInfo> samplers{};
+	///
+	/// \brief KTX2 file data (empty if the source image was invalid).
+	///
+	std::vector<std::span<std::byte const>> images{};
+	std::vector<Texture> textures{};
+	std::vector<Primitive> primitives{};
+	std::vector<Material> materials{};
+	std::vector<Mesh> meshes{};
+	std::vector<Camera> cameras{};
+	std::vector<Node> nodes{};
+	std::vector<Skin> skins{};
+	std::vector<Animation> animations{};
+	///
+	/// \brief Root nodes of each tree (GLTF scene).
+	///
+	std::vector<std::vector<std::size_t>> trees{};
+	std::optional<std::size_t> start_tree{};
+	///
+	/// \brief Opaque stamp of the sources and options the scene was cooked from (stored in the header).
+	///
+	std::uint64_t source_stamp{};
+
+	///
+	/// \brief Check if data is a cooked scene of the current version.
+	/// \param bytes Data to check
+	/// \returns true If bytes start with a valid header
+	///
+	static bool is_cooked(std::span<std::byte const> bytes);
+	///
+	/// \brief Read the source stamp from the header of a cooked scene file.
+	/// \param path Path to the cooked scene
+	/// \returns Source stamp, or nullopt if the file is missing or not a cooked scene of the current version
+	///
+	static std::optional<std::uint64_t> read_stamp(char const* path);
+	///
+	/// \brief Parse a cooked scene.
+	/// \param bytes Cooked scene file data (must outlive the returned instance)
+	/// \returns CookedScene with payloads viewing bytes
+	///
+	/// This function purposely throws on invalid / corrupt data.
+	///
+	static CookedScene read(std::span<std::byte const> bytes) noexcept(false);
+
+	///
+	/// \brief Write the cooked scene to a file.
+	/// \param path Path to write to
+	/// \returns true If successfully written
+	///
+	/// Data is written to a temporary file first and then renamed, readers never observe partial files.
+	///
+	bool write(char const* path) const;
+};
+} // namespace facade
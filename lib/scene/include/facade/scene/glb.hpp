@@ -0,0 +1,56 @@
+#pragma once
+#include <djson/json.hpp>
+#include <facade/util/data_provider.hpp>
+#include <string_view>
+
+namespace facade {
+///
+/// \brief DataProvider for binary GLTF (GLB) files.
+///
+/// The file is mapped once: the JSON chunk is parsed from the mapping, and the BIN chunk is served as a view into it.
+/// External URIs (if any) are resolved relative to the file's parent directory.
+///
+class GlbDataProvider : public DataProvider {
+  public:
+	///
+	/// \brief File extension of GLB files.
+	///
+	static constexpr std::string_view extension_v{".glb"};
+	///
+	/// \brief URI assigned to the (URI-less) buffer referring to the BIN chunk.
+	///
+	static constexpr std::string_view bin_uri_v{"[glb]:bin"};
+
+	///
+	/// \brief Check if data is a GLB container.
+	/// \param bytes (Start of the) file data
+	/// \returns true If bytes start with a valid GLB (version 2) header
+	///
+	static bool is_glb(std::span<std::byte const> bytes);
+
+	///
+	/// \brief Construct an instance and map a GLB file.
+	/// \param path Path to the GLB file
+	///
+	/// Failure to map or validate the file results in an empty instance.
+	///
+	explicit GlbDataProvider(char const* path);
+
+	///
+	/// \brief Parse the JSON chunk.
+	/// \returns Root JSON node, with the BIN chunk buffer's URI set to bin_uri_v
+	///
+	dj::Json json() const;
+
+	ByteBuffer load(std::string_view uri) const override;
+	DataView view(std::string_view uri) const override;
+
+	explicit operator bool() const { return static_cast<bool>(m_file); }
+
+  private:
+	FileDataProvider m_parent;
+	DataView m_file{};
+	std::string_view m_json{};
+	DataView m_bin{};
+};
+} // namespace facade
@@ -1,6 +1,10 @@
+#pragma once
 #include <djson/json.hpp>
+#include <facade/scene/load_options.hpp>
 #include <facade/scene/load_status.hpp>
 #include <facade/scene/scene.hpp>
+#include <facade/util/pinned.hpp>
+#include <facade/util/task.hpp>
 #include <facade/util/thread_pool.hpp>
 #include <atomic>
 
@@ -20,13 +24,36 @@ struct AtomicLoadStatus {
 	}
 };
 
+///
+/// \brief Wall-clock durations (in seconds) of each stage of a GLTF load.
+///
+/// Stages run concurrently as a task graph: each duration spans from when the stage started to when its last task completed.
+///
+struct LoadTimings {
+	float parse{};
+	float images{};
+	float textures{};
+	float primitives{};
+	///
+	/// \brief Animations, skins, and nodes.
+	///
+	float conversions{};
+	float build{};
+	float total{};
+
+	///
+	/// \brief Log all timings.
+	///
+	void log() const;
+};
+
 template <typename T>
 struct LoadFuture : MaybeFuture<T> {
 	LoadFuture() = default;
 
 	template <typename F>
 	LoadFuture(ThreadPool& pool, std::atomic<std::size_t>& post_increment, F func)
-		: MaybeFuture<T>(pool, [&post_increment, f = std::move(func)] {
+		: MaybeFuture<T>(pool, [&post_increment, f = std::move(func)]() mutable {
 			  auto ret = f();
 			  ++post_increment;
 			  return ret;
@@ -38,14 +65,67 @@ struct LoadFuture : MaybeFuture<T> {
 	}
 };
 
+template <typename F>
+auto make_load_future(ThreadPool* pool, std::atomic<std::size_t>& out_done, F func) -> LoadFuture<std::invoke_result_t<F>> {
+	if (pool) { return {*pool, out_done, std::move(func)}; }
+	return {out_done, std::move(func)};
+}
+
+template <typename T>
+std::vector<T> from_maybe_futures(std::vector<MaybeFuture<T>>&& futures) {
+	auto ret = std::vector<T>{};
+	ret.reserve(futures.size());
+	for (auto& future : futures) { ret.push_back(future.get()); }
+	return ret;
+}
+
+template <typename T>
+void wait_on(Task<T> const& task) {
+	if (task.valid()) { task.wait(); }
+}
+
+template <typename T>
+void wait_on(MaybeFuture<T> const& future) {
+	if (!future.future.valid()) { return; }
+	if (future.pool) {
+		future.pool->wait(future.future);
+	} else {
+		future.future.wait();
+	}
+}
+
+template <typename T>
+void wait_on(std::vector<T> const& tasks) {
+	for (auto const& task : tasks) { wait_on(task); }
+}
+
+///
+/// rief Waits on outstanding tasks when a loading frame unwinds (eg on exceptions), as the tasks reference its locals.
+///
+/// Must be declared after the locals referenced by the tasks, so that it is destroyed before them.
+///
+template <typename T>
+class WaitGuard : public Pinned {
+  public:
+	explicit WaitGuard(T const& tasks) : m_tasks(tasks) {}
+	~WaitGuard() { wait_on(m_tasks); }
+
+  private:
+	T const& m_tasks;
+};
+
 class Scene::GltfLoader {
   public:
 	///
 	/// \brief Construct a GltfLoader.
 	/// \param out_scene The scene to load into
 	/// \param out_status AtomicLoadStatus to be updated as the scene is loaded
+	/// \param options Optional processing to apply to loaded data
 	///
-	GltfLoader(Scene& out_scene, AtomicLoadStatus& out_status) : m_scene(out_scene), m_status(out_status) { m_status.reset(); }
+	GltfLoader(Scene& out_scene, AtomicLoadStatus& out_status, LoadOptions const& options = {})
+		: m_scene(out_scene), m_status(out_status), m_options(options) {
+		m_status.reset();
+	}
 
 	///
 	/// \brief Load data from a GLTF file.
@@ -58,13 +138,45 @@ class Scene::GltfLoader {
 	/// This function purposely throws on fatal errors.
 	///
 	bool operator()(dj::Json const& json, DataProvider const& provider, ThreadPool* thread_pool = {}) noexcept(false);
+
+	///
+	/// \brief Process a GLTF asset into a cooked scene file (see CookedScene), without a GPU.
+	/// \param out_path Path to write the cooked scene to
+	/// \param json The root JSON node for the GLTF asset
+	/// \param provider Data provider with the JSON parent directory mounted
+	/// \param options Optional processing to apply (compress_textures and texture_cache are honoured, stream_textures is ignored)
+	/// \param thread_pool Optional pointer to thread pool to use for async encoding of images and processing of meshes
+	/// \param source_stamp Stamp to store in the cooked scene (see source_stamp())
+	/// \returns true If successfully cooked and written
+	///
+	/// Images that are not block compressed are cooked as RGBA8 with a full mip chain.
+	/// This function purposely throws on fatal errors.
+	///
+	static bool cook(char const* out_path, dj::Json const& json, DataProvider const& provider, LoadOptions const& options = {},
+					 ThreadPool* thread_pool = {}, std::uint64_t source_stamp = {}) noexcept(false);
+	///
+	/// \brief Obtain a stamp identifying the sources and options a GLTF asset would be cooked from.
+	/// \param path Path to the GLTF / GLB file
+	/// \param json The root JSON node for the GLTF asset
+	/// \param options Load options to cook with
+	/// \returns Hash of the modification times of path and external buffer / image URIs, and the options that affect cooked data
+	///
+	/// A cooked scene is stale if its stamp (CookedScene::read_stamp()) differs from this one.
+	///
+	static std::uint64_t source_stamp(char const* path, dj::Json const& json, LoadOptions const& options);
 	///
 	/// \brief Obtain the load status.
 	///
 	AtomicLoadStatus const& load_status() const { return m_status; }
+	///
+	/// \brief Obtain the stage timings of the last successful load.
+	///
+	LoadTimings const& timings() const { return m_timings; }
 
   private:
 	Scene& m_scene;
 	AtomicLoadStatus& m_status;
+	LoadOptions m_options;
+	LoadTimings m_timings{};
 };
 } // namespace facade
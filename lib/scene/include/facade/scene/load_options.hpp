@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace facade {
+///
+/// \brief Optional processing applied to GLTF assets while loading.
+///
+struct LoadOptions {
+	///
+	/// \brief Merge duplicate vertices of (non-skinned) primitives, generating indices where missing.
+	///
+	bool weld_vertices{};
+	///
+	/// \brief Reorder triangle list primitives for vertex cache, overdraw, and vertex fetch locality.
+	///
+	/// Primitives split into meshlets are reordered within each meshlet (vertex cache and fetch locality only).
+	///
+	bool optimize_meshes{};
+	///
+	/// \brief Split (non-skinned) triangle list primitives into meshlets for view culling.
+	///
+	bool build_meshlets{true};
+	///
+	/// \brief Minimum triangles in a primitive for it to be split into meshlets.
+	///
+	std::uint32_t meshlet_min_triangles{4096};
+	///
+	/// \brief Encode PNG / JPG / etc images as BC7 / BC5 while loading (if supported by the GPU).
+	///
+	bool compress_textures{};
+	///
+	/// \brief Directory to cache encoded images in (caching is disabled if empty).
+	///
+	std::string texture_cache{};
+	///
+	/// \brief Upload only the smallest mip levels of compressed textures while loading, streaming in the rest after.
+	///
+	bool stream_textures{};
+	///
+	/// \brief Cook GLTF assets into a cooked scene (next to the source) on first load, and load that until the sources or options change.
+	///
+	bool cook_scenes{};
+};
+} // namespace facade
@@ -2,6 +2,7 @@
 #include <facade/scene/id.hpp>
 #include <facade/scene/resource_array.hpp>
 #include <facade/util/colour_space.hpp>
+#include <facade/util/flex_array.hpp>
 #include <facade/vk/texture.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
@@ -107,5 +108,10 @@ struct Material {
 	void write_sets(Pipeline& pipeline, TextureStore const& store) const {
 		std::visit([&pipeline, &store](auto const& mat) { mat.write_sets(pipeline, store); }, instance);
 	}
+
+	///
+	/// \brief Obtain the Ids of all textures referenced by the material.
+	///
+	FlexArray<Id<Texture>, 3> textures() const;
 };
 } // namespace facade
@@ -6,12 +6,15 @@
 #include <facade/util/image.hpp>
 #include <facade/util/ptr.hpp>
 #include <facade/util/transform.hpp>
+#include <map>
 #include <memory>
 #include <span>
+#include <tuple>
 #include <vector>
 
 namespace facade {
 struct DataProvider;
+class ThreadPool;
 
 ///
 /// \brief Polygon rendering mode: applied scene-wide.
@@ -21,6 +24,16 @@ struct RenderMode {
 
 	Type type{Type::eFill};
 	float line_width{1.0f};
+	///
+	/// \brief Cull meshlets outside the view frustum.
+	///
+	bool frustum_cull{true};
+	///
+	/// \brief Cull meshlets facing away from the camera.
+	///
+	/// Pipelines rasterize both faces, so this is only correct for closed / single sided geometry.
+	///
+	bool backface_cull{};
 
 	bool operator==(RenderMode const&) const = default;
 };
@@ -37,6 +50,8 @@ class Scene {
 
 	// defined in loader.hpp
 	class GltfLoader;
+	// defined in cooked_loader.hpp
+	class CookedLoader;
 
 	///
 	/// \brief Represents a single GTLF scene.
@@ -62,6 +77,8 @@ class Scene {
 	/// \param create_info Initialization data for the Sampler to create
 	/// \returns Id to stored Sampler
 	///
+	/// Samplers are cached by their create info (ignoring names): adding an identical one returns the existing Id.
+	///
 	Id<Sampler> add(Sampler::CreateInfo const& create_info);
 	///
 	/// \brief Add a Material.
@@ -214,8 +231,9 @@ class Scene {
 	///
 	/// \brief Update animations and corresponding nodes.
 	/// \param dt Duration to advance simulation by (time since last call to tick)
+	/// \param thread_pool Optional pointer to thread pool to sample animations on (at high priority)
 	///
-	void tick(float dt);
+	void tick(float dt, ThreadPool* thread_pool = {});
 
   private:
 	struct TreeBuilder;
@@ -234,9 +252,12 @@ class Scene {
 		std::vector<Roots> trees{};
 	};
 
+	using SamplerKey = std::tuple<vk::SamplerAddressMode, vk::SamplerAddressMode, vk::Filter, vk::Filter>;
+
 	struct Storage {
 		Resources resources{};
 		Data data{};
+		std::map<SamplerKey, Id<Sampler>> samplers{};
 	};
 
 	Node make_camera_node(Id<Camera> id) const;
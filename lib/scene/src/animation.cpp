@@ -1,10 +1,16 @@
 #include <facade/scene/animation.hpp>
 #include <facade/scene/node.hpp>
 #include <facade/util/bool.hpp>
+#include <facade/util/parallel.hpp>
 #include <facade/util/visitor.hpp>
 #include <facade/util/zip_ranges.hpp>
 
 namespace facade {
+namespace {
+// sampling a channel is cheap: only long animations are worth spreading across the pool
+constexpr std::size_t animator_grain_v{64};
+} // namespace
+
 MorphWeights lerp(MorphWeights const& a, MorphWeights const& b, float t) {
 	assert(a.weights.size() == b.weights.size());
 	auto ret = MorphWeights{};
@@ -16,23 +22,24 @@ float Animator::duration() const {
 	return std::visit([](auto const& ch) { return ch.duration(); }, channel);
 }
 
-void Animator::update(std::span<Node> nodes, float time) const {
-	if (!target) { return; }
+auto Animator::sample(float time) const -> Value {
+	if (!target) { return {}; }
+	auto const visitor = [time](auto const& interpolator) -> Value {
+		if (auto ret = interpolator(time)) { return std::move(*ret); }
+		return {};
+	};
+	return std::visit(visitor, channel);
+}
+
+void Animator::apply(std::span<Node> nodes, Value const& value) const {
+	if (!target || std::holds_alternative<std::monostate>(value)) { return; }
 	assert(*target < nodes.size());
 	auto& node = nodes[*target];
 	auto const visitor = Visitor{
-		[time, &node](Translate const& translate) {
-			if (auto const p = translate(time)) { node.transform.set_position(*p); }
-		},
-		[time, &node](Rotate const& rotate) {
-			if (auto const o = rotate(time)) { node.transform.set_orientation(*o); }
-		},
-		[time, &node](Scale const& scale) {
-			if (auto const s = scale(time)) { node.transform.set_scale(*s); }
-		},
-		[time, &node](Morph const& morph) {
-			if (auto const m = morph(time)) { node.weights = *m; }
-		},
+		[&value, &node](Translate const&) { node.transform.set_position(std::get<glm::vec3>(value)); },
+		[&value, &node](Rotate const&) { node.transform.set_orientation(std::get<glm::quat>(value)); },
+		[&value, &node](Scale const&) { node.transform.set_scale(std::get<glm::vec3>(value)); },
+		[&value, &node](Morph const&) { node.weights = std::get<MorphWeights>(value); },
 	};
 	std::visit(visitor, channel);
 }
@@ -42,10 +49,17 @@ void Animation::add(Animator animator) {
 	for (auto& animator : m_animators) { m_duration = std::max(animator.duration(), m_duration); }
 }
 
-void Animation::update(std::span<Node> nodes, float dt) {
+void Animation::update(std::span<Node> nodes, float dt, ThreadPool* thread_pool) {
 	if (!enabled()) { return; }
 	elapsed += dt * time_scale;
-	for (auto& animator : m_animators) { animator.update(nodes, elapsed); }
+	if (thread_pool && m_animators.size() > animator_grain_v) {
+		m_values.resize(m_animators.size());
+		parallel_for(thread_pool, m_animators.size(), animator_grain_v, [this](std::size_t index) { m_values[index] = m_animators[index].sample(elapsed); },
+					 ThreadPool::Priority::eHigh);
+		for (auto const& [animator, value] : zip_ranges(m_animators, m_values)) { animator.apply(nodes, value); }
+	} else {
+		for (auto& animator : m_animators) { animator.update(nodes, elapsed); }
+	}
 	if (elapsed > m_duration) { elapsed = {}; }
 }
 } // namespace facade
@@ -0,0 +1,132 @@
+#include <facade/scene/cooked_loader.hpp>
+#include <facade/scene/cooked_scene.hpp>
+#include <facade/util/enumerate.hpp>
+#include <facade/util/logger.hpp>
+#include <facade/util/mapped_file.hpp>
+#include <facade/util/parallel.hpp>
+#include <memory>
+
+namespace facade {
+namespace {
+// nodes are independent: converted in parallel chunks (serially for small scenes)
+constexpr std::size_t node_grain_v{256};
+
+std::vector<Node> to_nodes(std::span<CookedScene::Node const> nodes, ThreadPool* thread_pool) {
+	auto ret = std::vector<Node>(nodes.size());
+	parallel_for(thread_pool, nodes.size(), node_grain_v, [nodes, &ret](std::size_t index) {
+		auto const& in = nodes[index];
+		auto node = Node{.transform = in.data.transform, .self = index, .name = in.data.name};
+		node.children.reserve(in.data.children.size());
+		for (auto const& child : in.data.children) { node.children.push_back(child); }
+		if (in.data.camera) { node.attach<Camera>(*in.data.camera); }
+		if (in.data.mesh) { node.attach<Mesh>(*in.data.mesh); }
+		if (in.data.skin) { node.attach<Skin>(*in.data.skin); }
+		node.weights = in.weights;
+		ret[index] = std::move(node);
+	});
+	return ret;
+}
+} // namespace
+
+bool Scene::CookedLoader::operator()(char const* path, ThreadPool* thread_pool) noexcept(false) {
+	m_status.done = 0;
+	m_status.stage = LoadStage::eParsingJson;
+	auto const file = MappedFile{path, MappedFile::Access::eSequential};
+	if (!file || !CookedScene::is_cooked(file.bytes())) {
+		logger::error("[CookedLoader] Invalid cooked scene: [{}]", path);
+		return false;
+	}
+	// payloads view the mapping: it must outlive all uploads
+	auto cooked = CookedScene::read(file.bytes());
+	if (cooked.meshes.empty() || cooked.trees.empty()) {
+		logger::error("[CookedLoader] Cooked scene has no meshes / scenes: [{}]", path);
+		return false;
+	}
+	m_status.total = 1 + cooked.images.size() + cooked.textures.size() + cooked.primitives.size() + 1;
+
+	++m_status.done;
+	m_status.stage = LoadStage::eUploadingResources;
+	m_scene.m_storage = {};
+
+	// tasks view the mapping and reference locals: guards wait on them if this frame unwinds
+	auto image_futures = std::vector<MaybeFuture<std::shared_ptr<CompressedImage const>>>{};
+	auto const image_futures_guard = WaitGuard{image_futures};
+	for (auto [bytes, index] : enumerate(cooked.images)) {
+		auto func = [bytes, name = fmt::format("image_{}", index)]() mutable -> std::shared_ptr<CompressedImage const> {
+			if (bytes.empty()) { return {}; }
+			auto ret = CompressedImage{bytes, std::move(name)};
+			if (!ret) { return {}; }
+			return std::make_shared<CompressedImage>(std::move(ret));
+		};
+		image_futures.push_back(make_load_future(thread_pool, m_status.done, std::move(func)));
+	}
+
+	auto sampler_ids = std::vector<Id<Sampler>>{};
+	sampler_ids.reserve(cooked.samplers.size());
+	for (auto const& sampler : cooked.samplers) { sampler_ids.push_back(m_scene.add(sampler)); }
+	auto get_sampler = [&](std::optional<std::uint32_t> sampler) {
+		if (!sampler || *sampler >= sampler_ids.size()) { return m_scene.default_sampler(); }
+		return m_scene.m_storage.resources.samplers[sampler_ids[*sampler]].sampler();
+	};
+
+	auto const images = from_maybe_futures(std::move(image_futures));
+	auto textures = std::vector<MaybeFuture<Texture>>{};
+	auto const textures_guard = WaitGuard{textures};
+	textures.reserve(cooked.textures.size());
+	for (auto& texture : cooked.textures) {
+		auto func = [texture = std::move(texture), &images, &get_sampler, this] {
+			auto const tci = Texture::CreateInfo{
+				.name = std::move(texture.name),
+				.mip_mapped = texture.mip_mapped,
+				.colour_space = texture.colour_space,
+				.stream = m_options.stream_textures,
+			};
+			auto const sampler = get_sampler(texture.sampler);
+			for (auto const image : texture.images.span()) {
+				if (image >= images.size() || !images[image]) { continue; }
+				auto const& compressed = images[image];
+				if (Texture::is_supported(m_scene.m_gfx, compressed->view())) { return Texture{m_scene.m_gfx, sampler, compressed, tci}; }
+				logger::warn("[CookedLoader] Compressed image format not supported by GPU: [{}]", compressed->name());
+			}
+			// invalid / unsupported image: falls back to a (magenta) placeholder
+			return Texture{m_scene.m_gfx, sampler, Image::View{}, tci};
+		};
+		textures.push_back(make_load_future(thread_pool, m_status.done, std::move(func)));
+	}
+
+	auto mesh_primitives = std::vector<MaybeFuture<MeshPrimitive>>{};
+	auto const mesh_primitives_guard = WaitGuard{mesh_primitives};
+	mesh_primitives.reserve(cooked.primitives.size());
+	for (auto& primitive : cooked.primitives) {
+		auto func = [p = std::move(primitive), this]() mutable { return MeshPrimitive{m_scene.m_gfx, p.blob, std::move(p.name), std::move(p.meshlets)}; };
+		mesh_primitives.push_back(make_load_future(thread_pool, m_status.done, std::move(func)));
+	}
+
+	m_scene.m_storage.resources.animations.m_array = std::move(cooked.animations);
+	m_scene.m_storage.resources.skins.m_array = std::move(cooked.skins);
+	m_scene.m_storage.resources.nodes.m_array = to_nodes(cooked.nodes, thread_pool);
+
+	m_scene.replace(from_maybe_futures(std::move(textures)));
+	m_scene.replace(from_maybe_futures(std::move(mesh_primitives)));
+
+	m_status.stage = LoadStage::eBuildingScenes;
+	if (cooked.cameras.empty()) {
+		m_scene.add(Camera{.name = "default"});
+	} else {
+		for (auto& camera : cooked.cameras) { m_scene.add(std::move(camera)); }
+	}
+	for (auto& material : cooked.materials) { m_scene.add(std::move(material)); }
+	for (auto& mesh : cooked.meshes) { m_scene.add(std::move(mesh)); }
+
+	m_scene.m_storage.data.nodes.reserve(cooked.nodes.size());
+	for (auto& node : cooked.nodes) { m_scene.m_storage.data.nodes.push_back(std::move(node.data)); }
+	for (auto const& tree : cooked.trees) {
+		auto& roots = m_scene.m_storage.data.trees.emplace_back();
+		for (auto id : tree) { roots.push_back(id); }
+	}
+
+	auto const ret = m_scene.load(cooked.start_tree.value_or(0));
+	m_status.reset();
+	return ret;
+}
+} // namespace facade
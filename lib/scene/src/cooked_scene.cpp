@@ -0,0 +1,481 @@
+#include <facade/scene/cooked_scene.hpp>
+#include <facade/util/atomic_file_writer.hpp>
+#include <facade/util/error.hpp>
+#include <facade/util/flex_array.hpp>
+#include <algorithm>
+#include <concepts>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <utility>
+
+namespace facade {
+namespace {
+constexpr char magic_v[4] = {'F', 'C', 'S', 'N'};
+// bump when the layout of any table (or verbatim type) changes
+constexpr std::uint32_t version_v{3};
+// sections start on page boundaries: payloads can be mapped / prefetched without touching tables
+constexpr std::size_t section_align_v{4096};
+// satisfies texel block and vertex attribute alignment
+constexpr std::size_t payload_align_v{16};
+
+struct Header {
+	char magic[4]{};
+	std::uint32_t version{};
+	std::uint64_t tables_offset{};
+	std::uint64_t tables_size{};
+	std::uint64_t payloads_offset{};
+	std::uint64_t payloads_size{};
+	std::uint64_t source_stamp{};
+};
+
+// offset is relative to the payloads section
+struct Payload {
+	std::uint64_t offset{};
+	std::uint64_t size{};
+};
+
+constexpr std::uint64_t align(std::uint64_t size, std::uint64_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+
+template <typename T>
+struct IsFlexArray : std::false_type {};
+
+template <typename T, std::size_t Capacity>
+struct IsFlexArray<FlexArray<T, Capacity>> : std::true_type {};
+
+// trivially copyable types holding bools, enums, or sizes: stored member-wise so that every field is validated when read
+template <typename T>
+concept Structured = IsFlexArray<T>::value || std::same_as<T, Transform> || std::same_as<T, MorphWeights> ||
+					 std::same_as<T, Interpolator<MorphWeights>::Keyframe> || std::same_as<T, MeshPrimitive::Info> || std::same_as<T, Mesh::Primitive> ||
+					 std::same_as<T, LitMaterial> || std::same_as<T, UnlitMaterial>;
+
+// trivially copyable types are stored as-is, except views into payloads
+template <typename T>
+concept Verbatim =
+	std::is_trivially_copyable_v<T> && !std::same_as<T, std::span<std::byte const>> && !std::same_as<T, MeshPrimitive::Blob> && !Structured<T>;
+
+template <typename T, typename U>
+concept Is = std::same_as<std::remove_const_t<T>, U>;
+
+template <typename E>
+constexpr bool in_range(E const e, E const first, E const last) {
+	return e >= first && e <= last;
+}
+
+// only enumerators that the cooker writes are valid
+constexpr bool is_valid(vk::SamplerAddressMode const mode) {
+	return in_range(mode, vk::SamplerAddressMode::eRepeat, vk::SamplerAddressMode::eMirrorClampToEdge);
+}
+constexpr bool is_valid(vk::Filter const filter) { return in_range(filter, vk::Filter::eNearest, vk::Filter::eLinear); }
+constexpr bool is_valid(vk::IndexType const type) { return in_range(type, vk::IndexType::eUint16, vk::IndexType::eUint32); }
+constexpr bool is_valid(ColourSpace const colour_space) { return in_range(colour_space, ColourSpace::eSrgb, ColourSpace::eLinear); }
+constexpr bool is_valid(AlphaMode const mode) { return in_range(mode, AlphaMode::eOpaque, AlphaMode::eMask); }
+constexpr bool is_valid(Topology const topology) { return in_range(topology, Topology::ePoints, Topology::eTriangleFan); }
+constexpr bool is_valid(Interpolation const interpolation) { return in_range(interpolation, Interpolation::eLinear, Interpolation::eCubic); }
+
+// the cached matrix is recomputed on first use
+template <typename Ar, Is<Transform> T>
+void io(Ar& ar, T& transform) {
+	if constexpr (Ar::reading_v) {
+		auto data = Transform::Data{};
+		ar(data);
+		transform.set_data(data);
+	} else {
+		ar(transform.data());
+	}
+}
+
+template <typename Ar, Is<MorphWeights> T>
+void io(Ar& ar, T& weights) {
+	ar(weights.weights);
+}
+
+template <typename Ar, Is<Interpolator<MorphWeights>::Keyframe> T>
+void io(Ar& ar, T& keyframe) {
+	ar(keyframe.value, keyframe.timestamp);
+}
+
+template <typename Ar, Is<MeshPrimitive::Info> T>
+void io(Ar& ar, T& info) {
+	ar(info.vertices, info.indices, info.index_type);
+}
+
+template <typename Ar, Is<Mesh::Primitive> T>
+void io(Ar& ar, T& primitive) {
+	ar(primitive.primitive, primitive.material, primitive.topology);
+}
+
+template <typename Ar, Is<LitMaterial> T>
+void io(Ar& ar, T& lit) {
+	ar(lit.albedo, lit.emissive_factor, lit.metallic, lit.roughness, lit.base_colour, lit.roughness_metallic, lit.emissive, lit.alpha_cutoff, lit.alpha_mode);
+}
+
+template <typename Ar, Is<UnlitMaterial> T>
+void io(Ar& ar, T& unlit) {
+	ar(unlit.tint, unlit.texture);
+}
+
+template <typename Ar, Is<Sampler::CreateInfo> T>
+void io(Ar& ar, T& info) {
+	ar(info.name, info.mode_s, info.mode_t, info.min, info.mag);
+}
+
+template <typename Ar, Is<CookedScene::Texture> T>
+void io(Ar& ar, T& texture) {
+	ar(texture.name, texture.images, texture.sampler, texture.colour_space, texture.mip_mapped);
+}
+
+template <typename Ar, Is<MeshPrimitive::Blob> T>
+void io(Ar& ar, T& blob) {
+	ar(blob.bytes, blob.info, blob.skinned);
+}
+
+template <typename Ar, Is<CookedScene::Primitive> T>
+void io(Ar& ar, T& primitive) {
+	ar(primitive.name, primitive.blob, primitive.meshlets);
+}
+
+template <typename Ar, Is<Material> T>
+void io(Ar& ar, T& material) {
+	ar(material.instance, material.name);
+}
+
+template <typename Ar, Is<Mesh> T>
+void io(Ar& ar, T& mesh) {
+	ar(mesh.name, mesh.primitives);
+}
+
+template <typename Ar, Is<Camera> T>
+void io(Ar& ar, T& camera) {
+	ar(camera.name, camera.type, camera.exposure);
+}
+
+template <typename Ar, Is<NodeData> T>
+void io(Ar& ar, T& node) {
+	ar(node.name, node.transform, node.children, node.index, node.camera, node.mesh, node.skin);
+}
+
+template <typename Ar, Is<CookedScene::Node> T>
+void io(Ar& ar, T& node) {
+	ar(node.data, node.weights);
+}
+
+template <typename Ar, Is<Skin> T>
+void io(Ar& ar, T& skin) {
+	ar(skin.inverse_bind_matrices, skin.skeleton, skin.joints, skin.name);
+}
+
+// Animator channels (Translate, Rotate, etc)
+template <typename Ar, typename T>
+	requires requires(T& t) {
+		t.keyframes;
+		t.interpolation;
+	}
+void io(Ar& ar, T& interpolator) {
+	ar(interpolator.keyframes, interpolator.interpolation);
+}
+
+template <typename Ar, Is<Animator> T>
+void io(Ar& ar, T& animator) {
+	ar(animator.channel, animator.target);
+}
+
+template <typename Ar, Is<Animation> T>
+void io(Ar& ar, T& animation) {
+	ar(animation.name, animation.time_scale);
+	if constexpr (Ar::reading_v) {
+		// adding animators also accumulates the duration
+		auto animators = std::vector<Animator>{};
+		ar(animators);
+		for (auto& animator : animators) { animation.add(std::move(animator)); }
+	} else {
+		ar(animation.animators());
+	}
+}
+
+template <typename Ar, Is<CookedScene> T>
+void io(Ar& ar, T& scene) {
+	ar(scene.samplers, scene.images, scene.textures, scene.primitives, scene.materials, scene.meshes);
+	ar(scene.cameras, scene.nodes, scene.skins, scene.animations, scene.trees, scene.start_tree);
+}
+
+struct Writer {
+	static constexpr bool reading_v{false};
+
+	std::vector<std::byte> tables{};
+	std::vector<std::span<std::byte const>> payloads{};
+	std::uint64_t payloads_size{};
+
+	template <Verbatim T>
+	void operator()(T const& t) {
+		auto const bytes = std::as_bytes(std::span{&t, 1});
+		tables.insert(tables.end(), bytes.begin(), bytes.end());
+	}
+
+	void operator()(std::string const& str) {
+		(*this)(std::uint64_t{str.size()});
+		auto const bytes = std::as_bytes(std::span{str});
+		tables.insert(tables.end(), bytes.begin(), bytes.end());
+	}
+
+	void operator()(std::span<std::byte const> payload) {
+		payloads_size = align(payloads_size, payload_align_v);
+		(*this)(Payload{.offset = payloads_size, .size = payload.size()});
+		payloads.push_back(payload);
+		payloads_size += payload.size();
+	}
+
+	template <typename T>
+	void operator()(std::optional<T> const& t) {
+		(*this)(t.has_value());
+		if (t) { (*this)(*t); }
+	}
+
+	template <typename T>
+	void operator()(std::span<T const> ts) {
+		(*this)(std::uint64_t{ts.size()});
+		if constexpr (Verbatim<T>) {
+			auto const bytes = std::as_bytes(ts);
+			tables.insert(tables.end(), bytes.begin(), bytes.end());
+		} else {
+			for (auto const& t : ts) { (*this)(t); }
+		}
+	}
+
+	template <typename T>
+	void operator()(std::vector<T> const& ts) {
+		(*this)(std::span<T const>{ts});
+	}
+
+	template <typename T, std::size_t Capacity>
+	void operator()(FlexArray<T, Capacity> const& ts) {
+		(*this)(ts.span());
+	}
+
+	template <typename... T>
+	void operator()(std::variant<T...> const& v) {
+		(*this)(static_cast<std::uint32_t>(v.index()));
+		std::visit([this](auto const& t) { (*this)(t); }, v);
+	}
+
+	template <typename T>
+		requires(!Verbatim<T>)
+	void operator()(T const& t) {
+		io(*this, t);
+	}
+
+	template <typename... T>
+		requires(sizeof...(T) > 1)
+	void operator()(T const&... t) {
+		((*this)(t), ...);
+	}
+};
+
+struct Reader {
+	static constexpr bool reading_v{true};
+
+	std::span<std::byte const> tables{};
+	std::span<std::byte const> payloads{};
+	std::size_t offset{};
+
+	std::span<std::byte const> take(std::uint64_t size) {
+		if (size > tables.size() - offset) { throw Error{"Corrupt cooked scene: truncated tables"}; }
+		auto const ret = tables.subspan(offset, static_cast<std::size_t>(size));
+		offset += ret.size();
+		return ret;
+	}
+
+	std::size_t count(std::size_t element_size) {
+		auto ret = std::uint64_t{};
+		(*this)(ret);
+		// every element occupies at least one byte: reject counts that cannot fit (and would allocate absurd amounts)
+		if (ret > (tables.size() - offset) / std::max(element_size, std::size_t{1})) { throw Error{"Corrupt cooked scene: invalid count"}; }
+		return static_cast<std::size_t>(ret);
+	}
+
+	template <Verbatim T>
+	void operator()(T& out) {
+		std::memcpy(&out, take(sizeof(T)).data(), sizeof(T));
+		if constexpr (std::is_enum_v<T>) {
+			if (!is_valid(out)) { throw Error{"Corrupt cooked scene: invalid enumerator"}; }
+		}
+	}
+
+	// copying arbitrary bytes into a bool is undefined behaviour
+	void operator()(bool& out) {
+		auto byte = std::uint8_t{};
+		(*this)(byte);
+		if (byte > 1) { throw Error{"Corrupt cooked scene: invalid flag"}; }
+		out = byte == 1;
+	}
+
+	void operator()(std::string& out) {
+		auto const bytes = take(count(1));
+		out.assign(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+	}
+
+	void operator()(std::span<std::byte const>& out) {
+		auto payload = Payload{};
+		(*this)(payload);
+		if (payload.offset > payloads.size() || payload.size > payloads.size() - payload.offset) {
+			throw Error{"Corrupt cooked scene: payload out of bounds"};
+		}
+		out = payloads.subspan(static_cast<std::size_t>(payload.offset), static_cast<std::size_t>(payload.size));
+	}
+
+	template <typename T>
+	void operator()(std::optional<T>& out) {
+		auto has_value = bool{};
+		(*this)(has_value);
+		out.reset();
+		if (has_value) { (*this)(out.emplace()); }
+	}
+
+	template <typename T>
+	void operator()(std::vector<T>& out) {
+		if constexpr (Verbatim<T>) {
+			out.resize(count(sizeof(T)));
+			auto const bytes = take(out.size() * sizeof(T));
+			std::memcpy(out.data(), bytes.data(), bytes.size());
+		} else {
+			out.resize(count(1));
+			for (auto& t : out) { (*this)(t); }
+		}
+	}
+
+	template <typename T, std::size_t Capacity>
+	void operator()(FlexArray<T, Capacity>& out) {
+		auto const size = count(1);
+		if (size > Capacity) { throw Error{"Corrupt cooked scene: invalid count"}; }
+		out.clear();
+		for (std::size_t i = 0; i < size; ++i) { (*this)(out.insert(T{})); }
+	}
+
+	template <typename... T>
+	void operator()(std::variant<T...>& out) {
+		auto index = std::uint32_t{};
+		(*this)(index);
+		if (index >= sizeof...(T)) { throw Error{"Corrupt cooked scene: invalid variant index"}; }
+		[&]<std::size_t... I>(std::index_sequence<I...>) { ((index == I ? (void)out.template emplace<I>() : void()), ...); }(std::index_sequence_for<T...>{});
+		std::visit([this](auto& t) { (*this)(t); }, out);
+	}
+
+	template <typename T>
+		requires(!Verbatim<T>)
+	void operator()(T& out) {
+		io(*this, out);
+	}
+
+	template <typename... T>
+		requires(sizeof...(T) > 1)
+	void operator()(T&... out) {
+		((*this)(out), ...);
+	}
+};
+
+void check_index(std::size_t const index, std::size_t const count, std::string_view const table) {
+	if (index >= count) { throw Error{fmt::format("Corrupt cooked scene: invalid {} index: {}", table, index)}; }
+}
+
+// tables index into each other: reject dangling indices before any of them are dereferenced
+void validate(CookedScene const& scene) {
+	for (auto const& texture : scene.textures) {
+		for (auto const image : texture.images.span()) { check_index(image, scene.images.size(), "image"); }
+		if (texture.sampler) { check_index(*texture.sampler, scene.samplers.size(), "sampler"); }
+	}
+	for (auto const& primitive : scene.primitives) {
+		// checked here rather than on upload: a throwing upload task would leave the others running
+		if (primitive.blob.bytes.size() < primitive.blob.required_size()) {
+			throw Error{fmt::format("Corrupt cooked scene: truncated mesh data: [{}]", primitive.name)};
+		}
+		for (auto const& meshlet : primitive.meshlets) {
+			auto const& range = meshlet.indices;
+			if (range.first_index > primitive.blob.info.indices || range.index_count > primitive.blob.info.indices - range.first_index) {
+				throw Error{fmt::format("Corrupt cooked scene: meshlet out of bounds: [{}]", primitive.name)};
+			}
+		}
+	}
+	for (auto const& material : scene.materials) {
+		for (auto const texture : material.textures().span()) { check_index(texture, scene.textures.size(), "texture"); }
+	}
+	for (auto const& mesh : scene.meshes) {
+		for (auto const& primitive : mesh.primitives) {
+			check_index(primitive.primitive, scene.primitives.size(), "primitive");
+			if (primitive.material) { check_index(*primitive.material, scene.materials.size(), "material"); }
+		}
+	}
+	for (auto const& node : scene.nodes) {
+		for (auto const child : node.data.children) { check_index(child, scene.nodes.size(), "node"); }
+		if (node.data.camera) { check_index(*node.data.camera, scene.cameras.size(), "camera"); }
+		if (node.data.mesh) { check_index(*node.data.mesh, scene.meshes.size(), "mesh"); }
+		if (node.data.skin) { check_index(*node.data.skin, scene.skins.size(), "skin"); }
+	}
+	for (auto const& skin : scene.skins) {
+		for (auto const joint : skin.joints) { check_index(joint, scene.nodes.size(), "joint"); }
+		if (skin.skeleton) { check_index(*skin.skeleton, scene.nodes.size(), "skeleton"); }
+	}
+	for (auto const& animation : scene.animations) {
+		for (auto const& animator : animation.animators()) {
+			if (animator.target) { check_index(*animator.target, scene.nodes.size(), "animation target"); }
+		}
+	}
+	for (auto const& tree : scene.trees) {
+		for (auto const root : tree) { check_index(root, scene.nodes.size(), "root node"); }
+	}
+	if (scene.start_tree) { check_index(*scene.start_tree, scene.trees.size(), "tree"); }
+}
+
+} // namespace
+
+bool CookedScene::is_cooked(std::span<std::byte const> bytes) {
+	auto header = Header{};
+	if (bytes.size() < sizeof(header)) { return false; }
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	return std::memcmp(header.magic, magic_v, sizeof(magic_v)) == 0 && header.version == version_v;
+}
+
+std::optional<std::uint64_t> CookedScene::read_stamp(char const* path) {
+	auto file = std::ifstream{path, std::ios::binary};
+	auto header = Header{};
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) { return {}; }
+	if (std::memcmp(header.magic, magic_v, sizeof(magic_v)) != 0 || header.version != version_v) { return {}; }
+	return header.source_stamp;
+}
+
+CookedScene CookedScene::read(std::span<std::byte const> bytes) {
+	if (!is_cooked(bytes)) { throw Error{"Invalid cooked scene (or version mismatch)"}; }
+	auto header = Header{};
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	auto const section = [bytes](std::uint64_t offset, std::uint64_t size) {
+		if (offset > bytes.size() || size > bytes.size() - offset) { throw Error{"Corrupt cooked scene: section out of bounds"}; }
+		return bytes.subspan(static_cast<std::size_t>(offset), static_cast<std::size_t>(size));
+	};
+	auto reader = Reader{.tables = section(header.tables_offset, header.tables_size), .payloads = section(header.payloads_offset, header.payloads_size)};
+	auto ret = CookedScene{.source_stamp = header.source_stamp};
+	reader(ret);
+	validate(ret);
+	return ret;
+}
+
+bool CookedScene::write(char const* path) const {
+	auto writer = Writer{};
+	writer(*this);
+	auto header = Header{.version = version_v, .source_stamp = source_stamp};
+	std::memcpy(header.magic, magic_v, sizeof(magic_v));
+	header.tables_offset = sizeof(Header);
+	header.tables_size = writer.tables.size();
+	header.payloads_offset = align(header.tables_offset + header.tables_size, section_align_v);
+	header.payloads_size = writer.payloads_size;
+
+	auto file = AtomicFileWriter{path};
+	file.write(std::as_bytes(std::span{&header, 1}));
+	file.write(writer.tables);
+	file.pad_to(header.payloads_offset);
+	// same alignment as Writer used to compute payload offsets
+	for (auto const payload : writer.payloads) {
+		file.pad_to(header.payloads_offset + align(file.written() - header.payloads_offset, payload_align_v));
+		file.write(payload);
+	}
+	return file.commit();
+}
+} // namespace facade
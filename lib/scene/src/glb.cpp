@@ -0,0 +1,98 @@
+#include <facade/scene/glb.hpp>
+#include <facade/util/logger.hpp>
+#include <cstring>
+#include <filesystem>
+
+namespace facade {
+namespace {
+namespace fs = std::filesystem;
+
+constexpr std::uint32_t magic_v{0x46546c67};		// "glTF"
+constexpr std::uint32_t chunk_json_v{0x4e4f534a}; // "JSON"
+constexpr std::uint32_t chunk_bin_v{0x004e4942};	// "BIN\0"
+
+struct Header {
+	std::uint32_t magic{};
+	std::uint32_t version{};
+	std::uint32_t length{};
+};
+
+struct ChunkHeader {
+	std::uint32_t length{};
+	std::uint32_t type{};
+};
+
+template <typename T>
+bool read(T& out, std::span<std::byte const> bytes, std::size_t offset) {
+	if (offset > bytes.size() || bytes.size() - offset < sizeof(T)) { return false; }
+	std::memcpy(&out, bytes.data() + offset, sizeof(T));
+	return true;
+}
+} // namespace
+
+bool GlbDataProvider::is_glb(std::span<std::byte const> bytes) {
+	auto header = Header{};
+	return read(header, bytes, 0) && header.magic == magic_v && header.version == 2;
+}
+
+GlbDataProvider::GlbDataProvider(char const* path) : m_parent(FileDataProvider::mount_parent_dir(path)) {
+	auto const filename = fs::path{path}.filename().generic_string();
+	auto file = m_parent.view(filename);
+	auto const bytes = file.bytes();
+	if (!is_glb(bytes)) {
+		logger::warn("[GlbDataProvider] Invalid GLB: [{}]", path);
+		return;
+	}
+	// chunks are 4 byte aligned: JSON first, followed by an optional BIN chunk
+	auto offset = sizeof(Header);
+	for (auto chunk = ChunkHeader{}; read(chunk, bytes, offset); offset += chunk.length) {
+		offset += sizeof(ChunkHeader);
+		if (chunk.length > bytes.size() - offset) {
+			logger::warn("[GlbDataProvider] Truncated chunk in GLB: [{}]", path);
+			return;
+		}
+		if (chunk.type == chunk_json_v && m_json.empty()) {
+			m_json = {reinterpret_cast<char const*>(bytes.data() + offset), chunk.length};
+		} else if (chunk.type == chunk_bin_v && !m_bin) {
+			m_bin = file.subview(offset, chunk.length);
+		}
+	}
+	if (m_json.empty()) {
+		logger::warn("[GlbDataProvider] Missing JSON chunk in GLB: [{}]", path);
+		return;
+	}
+	m_file = std::move(file);
+}
+
+dj::Json GlbDataProvider::json() const {
+	auto ret = dj::Json::parse(m_json);
+	if (!m_bin) { return ret; }
+	// the first buffer without a URI refers to the BIN chunk: name it for the loader to request
+	auto buffers = dj::Json{};
+	bool bin_assigned{};
+	for (auto const& in : ret["buffers"].array_view()) {
+		// copied as-is (extensions, extras, etc): only the BIN chunk's URI is assigned
+		auto buffer = in;
+		if (!in["uri"] && !bin_assigned) {
+			buffer["uri"] = std::string{bin_uri_v};
+			bin_assigned = true;
+		}
+		buffers.push_back(std::move(buffer));
+	}
+	if (bin_assigned) { ret["buffers"] = std::move(buffers); }
+	return ret;
+}
+
+ByteBuffer GlbDataProvider::load(std::string_view uri) const {
+	if (uri != bin_uri_v) { return m_parent.load(uri); }
+	auto const bin = m_bin.bytes();
+	auto ret = ByteBuffer::make(bin.size());
+	std::memcpy(ret.data(), bin.data(), bin.size());
+	return ret;
+}
+
+DataView GlbDataProvider::view(std::string_view uri) const {
+	if (uri != bin_uri_v) { return m_parent.view(uri); }
+	return m_bin;
+}
+} // namespace facade
@@ -1,13 +1,32 @@
+#include <facade/scene/cooked_scene.hpp>
 #include <facade/scene/gltf_loader.hpp>
+#include <facade/util/block_compressor.hpp>
 #include <facade/util/data_provider.hpp>
 #include <facade/util/enumerate.hpp>
 #include <facade/util/error.hpp>
+#include <facade/util/hash_combine.hpp>
+#include <facade/util/logger.hpp>
+#include <facade/util/parallel.hpp>
+#include <facade/util/pinned.hpp>
+#include <facade/util/task.hpp>
 #include <facade/util/thread_pool.hpp>
+#include <facade/util/time.hpp>
 #include <facade/util/zip_ranges.hpp>
 #include <facade/vk/geometry.hpp>
+#include <facade/vk/mesh_optimizer.hpp>
+#include <facade/vk/meshlet.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 #include <gltf2cpp/gltf2cpp.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
 #include <span>
+#include <string>
+#include <tuple>
+#include <unordered_map>
 
 namespace facade {
 namespace {
@@ -79,16 +98,17 @@ Sampler::CreateInfo to_sampler_info(gltf2cpp::Sampler const& sampler) {
 	return ret;
 }
 
-Material to_material(gltf2cpp::Material const& material) {
+Material to_material(gltf2cpp::Material const& material, std::span<std::size_t const> texture_ids) {
+	auto to_texture_id = [texture_ids](std::size_t index) { return index < texture_ids.size() ? texture_ids[index] : index; };
 	auto ret = LitMaterial{};
 	ret.albedo = {material.pbr.base_color_factor[0], material.pbr.base_color_factor[1], material.pbr.base_color_factor[2]};
 	ret.metallic = material.pbr.metallic_factor;
 	ret.roughness = material.pbr.roughness_factor;
 	ret.alpha_mode = to_alpha_mode(material.alpha_mode);
 	ret.alpha_cutoff = material.alpha_cutoff;
-	if (material.pbr.base_color_texture) { ret.base_colour = material.pbr.base_color_texture->texture; }
-	if (material.pbr.metallic_roughness_texture) { ret.roughness_metallic = material.pbr.metallic_roughness_texture->texture; }
-	if (material.emissive_texture) { ret.emissive = material.emissive_texture->texture; }
+	if (material.pbr.base_color_texture) { ret.base_colour = to_texture_id(material.pbr.base_color_texture->texture); }
+	if (material.pbr.metallic_roughness_texture) { ret.roughness_metallic = to_texture_id(material.pbr.metallic_roughness_texture->texture); }
+	if (material.emissive_texture) { ret.emissive = to_texture_id(material.emissive_texture->texture); }
 	ret.emissive_factor = {material.emissive_factor[0], material.emissive_factor[1], material.emissive_factor[2]};
 	return Material{std::move(ret)};
 }
@@ -119,7 +139,7 @@ Geometry::Packed to_geometry(gltf2cpp::Mesh::Primitive&& primitive) {
 	if (ret.normals.empty()) { ret.normals = std::vector<glm::vec3>(ret.positions.size(), glm::vec3{0.0f, 0.0f, 1.0f}); }
 	if (!primitive.geometry.tex_coords.empty()) { ret.uvs = from_gltf<2>(primitive.geometry.tex_coords[0]); }
 	if (ret.uvs.empty()) { ret.uvs = std::vector<glm::vec2>(ret.positions.size()); }
-	ret.indices = std::move(primitive.geometry.indices);
+	ret.indices = Geometry::Packed::Indices::make(primitive.geometry.indices, ret.positions.size());
 	return ret;
 }
 
@@ -135,7 +155,8 @@ struct MeshLayout {
 		std::vector<glm::vec4> weights{};
 	};
 
-	std::vector<Primitive> primitives{};
+	// accessor data is converted by each primitive's task (to_mesh_layout_primitive), not up front
+	std::vector<gltf2cpp::Mesh::Primitive> primitives{};
 	std::vector<Data> data{};
 };
 
@@ -163,13 +184,94 @@ MeshLayout to_mesh_layout(gltf2cpp::Root& out_root) {
 				.material = primitive.material,
 				.topology = topology,
 			});
-			ret.primitives.push_back(to_mesh_layout_primitive(std::move(primitive)));
+			ret.primitives.push_back(std::move(primitive));
 		}
 		ret.data.push_back(std::move(data));
 	}
 	return ret;
 }
 
+struct MeshStats {
+	std::atomic<std::size_t> vertices_before{};
+	std::atomic<std::size_t> vertices_after{};
+	std::atomic<std::size_t> triangles{};
+	std::atomic<std::size_t> misses_before{};
+	std::atomic<std::size_t> misses_after{};
+	std::atomic<std::size_t> meshlets{};
+
+	void add_weld(std::size_t before, std::size_t after) {
+		vertices_before += before;
+		vertices_after += after;
+	}
+
+	void add(MeshOptimizer::Result const& result) {
+		triangles += result.triangles;
+		misses_before += result.misses_before;
+		misses_after += result.misses_after;
+	}
+
+	float acmr(std::size_t misses) const { return triangles == 0 ? 0.0f : static_cast<float>(misses) / static_cast<float>(triangles); }
+
+	void log() const {
+		if (vertices_before > vertices_after) { logger::info("[GltfLoader] Welded vertices: [{}] => [{}]", vertices_before.load(), vertices_after.load()); }
+		if (triangles > 0) {
+			logger::info("[GltfLoader] Optimized [{}] triangles, ACMR: [{:.3f}] => [{:.3f}]", triangles.load(), acmr(misses_before), acmr(misses_after));
+		}
+		if (meshlets > 0) { logger::info("[GltfLoader] Built meshlets: [{}]", meshlets.load()); }
+	}
+};
+
+MeshOptimizer::Result optimize(MeshLayout::Primitive& out_primitive, std::span<Meshlet const> meshlets) {
+	auto ranges = std::vector<IndexRange>{};
+	ranges.reserve(meshlets.size());
+	for (auto const& meshlet : meshlets) { ranges.push_back(meshlet.indices); }
+	auto ret = MeshOptimizer{}(out_primitive.geometry, ranges);
+	MeshOptimizer::remap_vertices(out_primitive.joints, ret.remap);
+	MeshOptimizer::remap_vertices(out_primitive.weights, ret.remap);
+	return ret;
+}
+
+struct PrimitiveProcess {
+	std::string name{};
+	bool weld{};
+	bool optimize{};
+	bool split{};
+	std::uint32_t split_min_triangles{};
+
+	static PrimitiveProcess make(LoadOptions const& options, gltf2cpp::Mesh::Primitive const& primitive, Topology topology, std::string name) {
+		bool const skinned = !primitive.geometry.joints.empty();
+		return PrimitiveProcess{
+			.name = std::move(name),
+			// welding would merge vertices with different joints / weights
+			.weld = options.weld_vertices && !skinned,
+			.optimize = options.optimize_meshes && topology == Topology::eTriangles,
+			// skinned vertices move away from their bind pose bounds
+			.split = options.build_meshlets && topology == Topology::eTriangles && !skinned,
+			.split_min_triangles = options.meshlet_min_triangles,
+		};
+	}
+
+	std::vector<Meshlet> operator()(MeshLayout::Primitive& out_primitive, MeshStats& out_stats) const {
+		if (weld) {
+			auto const before = out_primitive.geometry.positions.size();
+			out_primitive.geometry.weld();
+			out_stats.add_weld(before, out_primitive.geometry.positions.size());
+		}
+		// meshlets reorder the whole index buffer: built first, then optimized per meshlet so that ACMR is measured on the final order
+		auto ret = std::vector<Meshlet>{};
+		if (split && out_primitive.geometry.indices.size() / 3 >= split_min_triangles) {
+			ret = MeshletBuilder{}(out_primitive.geometry);
+			out_stats.meshlets += ret.size();
+		}
+		if (optimize) {
+			auto const result = facade::optimize(out_primitive, ret);
+			logger::debug("[GltfLoader] Optimized [{}], ACMR: [{:.3f}] => [{:.3f}]", name, result.acmr_before(), result.acmr_after());
+			out_stats.add(result);
+		}
+		return ret;
+	}
+};
+
 Transform to_transform(gltf2cpp::Transform const& transform) {
 	auto ret = Transform{};
 	auto visitor = Visitor{
@@ -204,21 +306,23 @@ NodeData to_node_data(gltf2cpp::Node&& node) {
 	};
 }
 
-std::vector<NodeData> to_node_data(std::span<gltf2cpp::Node> nodes) {
-	auto ret = std::vector<NodeData>{};
-	ret.reserve(nodes.size());
-	for (auto& in : nodes) {
-		auto& node = ret.emplace_back(to_node_data(std::move(in)));
-		node.index = ret.size() - 1;
-	}
+// nodes are independent: converted in parallel chunks (serially for small scenes)
+constexpr std::size_t node_grain_v{256};
+
+std::vector<NodeData> to_node_data(std::span<gltf2cpp::Node> nodes, ThreadPool* thread_pool) {
+	auto ret = std::vector<NodeData>(nodes.size());
+	parallel_for(thread_pool, nodes.size(), node_grain_v, [nodes, &ret](std::size_t index) {
+		ret[index] = to_node_data(std::move(nodes[index]));
+		ret[index].index = index;
+	});
 	return ret;
 }
 
-std::vector<Node> to_nodes(std::span<gltf2cpp::Node> nodes) {
-	auto ret = std::vector<Node>{};
-	ret.reserve(nodes.size());
-	for (auto& in : nodes) {
-		auto node = Node{.transform = to_transform(in.transform), .self = ret.size(), .name = std::move(in.name)};
+std::vector<Node> to_nodes(std::span<gltf2cpp::Node> nodes, ThreadPool* thread_pool) {
+	auto ret = std::vector<Node>(nodes.size());
+	parallel_for(thread_pool, nodes.size(), node_grain_v, [nodes, &ret](std::size_t index) {
+		auto& in = nodes[index];
+		auto node = Node{.transform = to_transform(in.transform), .self = index, .name = std::move(in.name)};
 		node.children.reserve(in.children.size());
 		for (auto const& child : in.children) { node.children.push_back(child); }
 		if (in.camera) { node.attach<Camera>(*in.camera); }
@@ -227,8 +331,8 @@ std::vector<Node> to_nodes(std::span<gltf2cpp::Node> nodes) {
 		for (float const weight : in.weights) {
 			if (node.weights.weights.size() < MorphWeights::max_weights_v) { node.weights.weights.insert(weight); }
 		}
-		ret.push_back(std::move(node));
-	}
+		ret[index] = std::move(node);
+	});
 	return ret;
 }
 
@@ -306,104 +410,560 @@ Skin to_skin(gltf2cpp::Skin&& skin, std::span<gltf2cpp::Accessor const> accessor
 	return ret;
 }
 
-template <typename F>
-auto make_load_future(ThreadPool* pool, std::atomic<std::size_t>& out_done, F func) -> LoadFuture<std::invoke_result_t<F>> {
-	if (pool) { return {*pool, out_done, std::move(func)}; }
-	return {out_done, std::move(func)};
+struct ImageData {
+	// decoded straight into staging memory: pixels are not copied again on the CPU before upload
+	StagedImage staged{};
+	// shared with streaming textures
+	std::shared_ptr<CompressedImage const> compressed{};
+};
+
+ImageData to_image_data(gltf2cpp::Image&& image, Gfx const& gfx, BlockCompressor const* compressor, BlockCompressor::Format format) {
+	auto ret = ImageData{};
+	if (CompressedImage::is_ktx2(image.bytes.span())) {
+		// Basis Universal payloads result in an empty image, leaving the texture to fall back to its core source
+		auto compressed = CompressedImage{image.bytes.span(), std::move(image.name)};
+		if (compressed) { ret.compressed = std::make_shared<CompressedImage>(std::move(compressed)); }
+		return ret;
+	}
+	if (compressor) {
+		if (auto compressed = (*compressor)(image.bytes.span(), format, image.name)) {
+			ret.compressed = std::make_shared<CompressedImage>(std::move(compressed));
+			return ret;
+		}
+	}
+	ret.staged = StagedImage{gfx, image.bytes.span(), std::move(image.name)};
+	return ret;
 }
 
-template <typename T>
-std::vector<T> from_maybe_futures(std::vector<MaybeFuture<T>>&& futures) {
-	auto ret = std::vector<T>{};
-	ret.reserve(futures.size());
-	for (auto& future : futures) { ret.push_back(future.get()); }
+// images only sampled as roughness-metallic (G, B channels) can be encoded as BC5
+std::vector<BlockCompressor::Format> to_block_formats(gltf2cpp::Root const& root) {
+	enum : std::uint8_t { eColour = 1 << 0, eRoughnessMetallic = 1 << 1 };
+	auto usage = std::vector<std::uint8_t>(root.images.size());
+	auto mark = [&](auto const& texture_info, std::uint8_t flag) {
+		if (!texture_info || texture_info->texture >= root.textures.size()) { return; }
+		if (auto const source = root.textures[texture_info->texture].source; source < usage.size()) { usage[source] |= flag; }
+	};
+	for (auto const& material : root.materials) {
+		mark(material.pbr.base_color_texture, eColour);
+		mark(material.pbr.metallic_roughness_texture, eRoughnessMetallic);
+		mark(material.emissive_texture, eColour);
+	}
+	auto ret = std::vector<BlockCompressor::Format>{};
+	ret.reserve(usage.size());
+	for (auto const flags : usage) { ret.push_back(flags == eRoughnessMetallic ? BlockCompressor::Format::eBc5 : BlockCompressor::Format::eBc7); }
 	return ret;
 }
+
+// maps each image to a unique image index: identical bytes (under different URIs) share one
+std::vector<std::size_t> to_unique_images(std::span<gltf2cpp::Image const> images) {
+	auto ret = std::vector<std::size_t>{};
+	ret.reserve(images.size());
+	auto firsts = std::vector<std::size_t>{};
+	auto by_hash = std::unordered_map<std::uint64_t, std::vector<std::size_t>>{};
+	for (auto const& image : images) {
+		auto const bytes = image.bytes.span();
+		auto& candidates = by_hash[BlockCompressor::hash(bytes)];
+		auto const same = [&](std::size_t unique) {
+			auto const other = images[firsts[unique]].bytes.span();
+			return std::equal(bytes.begin(), bytes.end(), other.begin(), other.end());
+		};
+		if (auto const it = std::find_if(candidates.begin(), candidates.end(), same); it != candidates.end()) {
+			ret.push_back(*it);
+			continue;
+		}
+		candidates.push_back(firsts.size());
+		ret.push_back(firsts.size());
+		firsts.push_back(ret.size() - 1);
+	}
+	return ret;
+}
+
+// KHR_texture_basisu: per texture KTX2 source image, the core source is the fallback
+std::vector<std::optional<std::size_t>> to_ktx2_sources(dj::Json const& json) {
+	auto ret = std::vector<std::optional<std::size_t>>{};
+	for (auto const& texture : json["textures"].array_view()) {
+		auto& source = ret.emplace_back();
+		if (auto const& ktx2 = texture["extensions"]["KHR_texture_basisu"]["source"]) { source = ktx2.as<std::size_t>(); }
+	}
+	return ret;
+}
+
+// reads all external buffer / image URIs concurrently: parsing only waits on the URI it needs next
+class UriPrefetch : public Pinned {
+  public:
+	UriPrefetch(dj::Json const& json, DataProvider const& provider, ThreadPool* thread_pool) : m_provider(provider) {
+		if (!thread_pool) { return; }
+		auto const prefetch = [&](dj::Json const& array) {
+			for (auto const& item : array.array_view()) {
+				auto const& uri = item["uri"];
+				if (!uri) { continue; }
+				auto key = std::string{uri.as_string()};
+				// data URIs are decoded by the parser
+				if (key.starts_with("data:") || m_futures.contains(key)) { continue; }
+				auto func = [p = &m_provider, key] { return p->load(key); };
+				m_futures.insert({std::move(key), MaybeFuture<ByteBuffer>{*thread_pool, std::move(func)}});
+			}
+		};
+		prefetch(json["buffers"]);
+		prefetch(json["images"]);
+	}
+
+	// tasks reference the provider: unclaimed reads (eg on parse failure) must complete first
+	~UriPrefetch() {
+		for (auto& [_, future] : m_futures) {
+			if (future.future.valid()) { future.pool->wait(future.future); }
+		}
+	}
+
+	gltf2cpp::ByteArray operator()(std::string_view uri) {
+		auto ret = ByteBuffer{};
+		if (auto it = m_futures.find(std::string{uri}); it != m_futures.end() && it->second.active()) {
+			ret = it->second.get();
+		} else {
+			ret = m_provider.load(uri);
+		}
+		return gltf2cpp::ByteArray{std::move(ret.bytes), ret.size};
+	}
+
+  private:
+	std::unordered_map<std::string, MaybeFuture<ByteBuffer>> m_futures{};
+	DataProvider const& m_provider;
+};
+
+struct ImageLayout {
+	// unique image index of each image
+	std::vector<std::size_t> unique{};
+	// block format of each unique image
+	std::vector<BlockCompressor::Format> formats{};
+
+	static ImageLayout make(gltf2cpp::Root const& root) {
+		auto ret = ImageLayout{.unique = to_unique_images(root.images)};
+		auto const block_formats = to_block_formats(root);
+		for (auto [unique, index] : enumerate(ret.unique)) {
+			if (unique == ret.formats.size()) {
+				ret.formats.push_back(block_formats[index]);
+			} else if (block_formats[index] != ret.formats[unique]) {
+				// a duplicate sampled as colour anywhere cannot be encoded as BC5
+				ret.formats[unique] = BlockCompressor::Format::eBc7;
+			}
+		}
+		return ret;
+	}
+
+	// unique indices are assigned in order: anything else is a duplicate of an image already being loaded
+	bool is_duplicate(std::size_t index, std::size_t loaded) const { return unique[index] != loaded; }
+
+	std::optional<std::size_t> get(std::optional<std::size_t> image) const {
+		if (!image || *image >= unique.size()) { return {}; }
+		return unique[*image];
+	}
+};
+
+struct TextureLayout {
+	struct Entry {
+		// index of the first GLTF texture using this entry
+		std::size_t texture{};
+		std::optional<std::size_t> ktx2{};
+		std::optional<std::size_t> source{};
+		std::optional<std::size_t> sampler{};
+	};
+
+	std::vector<Entry> unique{};
+	// unique texture index of each texture
+	std::vector<std::size_t> ids{};
+
+	// textures with identical sources, samplers, and colour spaces are shared
+	static TextureLayout make(gltf2cpp::Root const& root, dj::Json const& json, ImageLayout const& images, std::span<std::size_t const> sampler_ids) {
+		auto const ktx2_sources = to_ktx2_sources(json);
+		auto get_sampler_id = [sampler_ids](std::optional<std::size_t> sampler) -> std::optional<std::size_t> {
+			if (!sampler || *sampler >= sampler_ids.size()) { return {}; }
+			return sampler_ids[*sampler];
+		};
+		auto ret = TextureLayout{};
+		ret.ids.reserve(root.textures.size());
+		auto map = std::map<std::tuple<std::optional<std::size_t>, std::optional<std::size_t>, std::optional<std::size_t>, bool>, std::size_t>{};
+		for (auto [texture, index] : enumerate(root.textures)) {
+			auto entry = Entry{.texture = index, .source = images.get(texture.source), .sampler = get_sampler_id(texture.sampler)};
+			entry.ktx2 = images.get(index < ktx2_sources.size() ? ktx2_sources[index] : std::nullopt);
+			auto const [it, inserted] = map.insert({{entry.ktx2, entry.source, entry.sampler, texture.linear}, ret.unique.size()});
+			ret.ids.push_back(it->second);
+			if (inserted) { ret.unique.push_back(entry); }
+		}
+		return ret;
+	}
+};
+
+// cooked images are always KTX2: block compressed if requested, else RGBA8 (with mips)
+ByteBuffer to_ktx2(gltf2cpp::Image&& image, BlockCompressor const* compressor, BlockCompressor::Format format) {
+	auto const copy = [](std::span<std::byte const> bytes) {
+		auto ret = ByteBuffer::make(bytes.size());
+		std::memcpy(ret.data(), bytes.data(), bytes.size());
+		return ret;
+	};
+	if (CompressedImage::is_ktx2(image.bytes.span())) {
+		// Basis Universal payloads are dropped, leaving the texture to fall back to its core source
+		if (!CompressedImage{image.bytes.span(), image.name}) { return {}; }
+		return copy(image.bytes.span());
+	}
+	if (compressor) {
+		if (auto compressed = (*compressor)(image.bytes.span(), format, image.name)) { return copy(compressed.ktx2()); }
+	}
+	auto const decoded = Image{image.bytes.span(), std::move(image.name)};
+	if (!decoded) { return {}; }
+	return BlockCompressor::encode(decoded.view(), BlockCompressor::Format::eRgba8);
+}
+
+struct CookedPrimitive {
+	ByteBuffer bytes{};
+	CookedScene::Primitive primitive{};
+};
+
+template <typename F>
+auto make_maybe_future(ThreadPool* pool, F func) -> MaybeFuture<std::invoke_result_t<F>> {
+	if (pool) { return {*pool, std::move(func)}; }
+	return MaybeFuture<std::invoke_result_t<F>>{std::move(func)};
+}
+
+// wall-clock span of a stage whose tasks complete on arbitrary threads: from start to the last mark()
+struct StageTimer {
+	float start{time::since_start()};
+	std::atomic<float> end{};
+
+	void mark() {
+		auto const now = time::since_start();
+		auto prev = end.load();
+		while (prev < now && !end.compare_exchange_weak(prev, now)) {}
+	}
+
+	float elapsed() const { return std::max(end.load() - start, 0.0f); }
+};
 } // namespace
 
+void LoadTimings::log() const {
+	logger::info("[GltfLoader] Stage timings - parse: [{:.3f}s] images: [{:.3f}s] textures: [{:.3f}s] primitives: [{:.3f}s] conversions: [{:.3f}s] build: "
+				 "[{:.3f}s] total: [{:.3f}s]",
+				 parse, images, textures, primitives, conversions, build, total);
+}
+
 bool Scene::GltfLoader::operator()(dj::Json const& json, DataProvider const& provider, ThreadPool* thread_pool) noexcept(false) {
+	auto const start = time::since_start();
 	auto const parser = gltf2cpp::Parser{json};
 	auto const meta = parser.metadata();
 	m_status.done = 0;
 	m_status.total = 1 + meta.images + meta.textures + meta.primitives + 1;
 	m_status.stage = LoadStage::eParsingJson;
 
-	auto get_bytes = [&provider](std::string_view uri) {
-		auto ret = provider.load(uri);
-		return gltf2cpp::ByteArray{std::move(ret.bytes), ret.size};
-	};
+	auto parse_timer = StageTimer{};
+	auto prefetch = UriPrefetch{json, provider, thread_pool};
+	auto get_bytes = [&prefetch](std::string_view uri) { return prefetch(uri); };
 
 	auto root = parser.parse(get_bytes);
 	if (!root || root.meshes.empty() || root.scenes.empty()) { return false; }
 	if (root.start_scene && *root.start_scene >= root.scenes.size()) { throw Error{fmt::format("Invalid start scene: {}", *root.start_scene)}; }
+	parse_timer.mark();
 
 	++m_status.done;
 	m_status.stage = LoadStage::eUploadingResources;
 	m_scene.m_storage = {};
 
-	auto image_futures = std::vector<MaybeFuture<Image>>{};
-	image_futures.reserve(root.images.size());
-	for (auto& image : root.images) {
-		assert(!image.bytes.empty());
-		image_futures.push_back(make_load_future(thread_pool, m_status.done, [i = std::move(image)] { return Image{i.bytes.span(), std::move(i.name)}; }));
+	auto compressor = std::optional<BlockCompressor>{};
+	if (m_options.compress_textures) {
+		auto const& gfx = m_scene.m_gfx;
+		if (Texture::is_supported(gfx, vk::Format::eBc7UnormBlock) && Texture::is_supported(gfx, vk::Format::eBc5UnormBlock)) {
+			compressor.emplace(m_options.texture_cache, thread_pool);
+		} else {
+			logger::warn("[GltfLoader] BC7 / BC5 not supported by GPU, textures will not be compressed");
+		}
 	}
 
-	for (auto const& sampler : root.samplers) { m_scene.add(to_sampler_info(sampler)); }
+	auto sampler_ids = std::vector<std::size_t>{};
+	sampler_ids.reserve(root.samplers.size());
+	for (auto const& sampler : root.samplers) { sampler_ids.push_back(m_scene.add(to_sampler_info(sampler))); }
 	auto get_sampler = [this](std::optional<std::size_t> sampler_id) {
-		if (!sampler_id || sampler_id >= m_scene.m_storage.resources.samplers.size()) { return m_scene.default_sampler(); }
+		if (!sampler_id) { return m_scene.default_sampler(); }
 		return m_scene.m_storage.resources.samplers[*sampler_id].sampler();
 	};
 
-	auto textures = std::vector<MaybeFuture<Texture>>{};
-	textures.reserve(root.textures.size());
-	auto const images = from_maybe_futures(std::move(image_futures));
-	for (auto& texture : root.textures) {
-		textures.push_back(make_load_future(thread_pool, m_status.done, [texture = std::move(texture), &images, &get_sampler, this] {
-			bool const mip_mapped = !texture.linear;
-			auto const colour_space = texture.linear ? ColourSpace::eLinear : ColourSpace::eSrgb;
-			auto const tci = Texture::CreateInfo{.name = std::move(texture.name), .mip_mapped = mip_mapped, .colour_space = colour_space};
-			return Texture{m_scene.m_gfx, get_sampler(texture.sampler), images[texture.source], tci};
-		}));
+	// each texture is a continuation of its images: it starts as soon as they are decoded, without blocking a thread on them
+	auto const image_layout = ImageLayout::make(root);
+	auto image_timer = StageTimer{};
+	auto images = std::vector<Task<ImageData>>{};
+	auto const images_guard = WaitGuard{images};
+	images.reserve(image_layout.formats.size());
+	for (auto [image, index] : enumerate(root.images)) {
+		assert(!image.bytes.empty());
+		if (image_layout.is_duplicate(index, images.size())) {
+			++m_status.done;
+			continue;
+		}
+		auto const* c = compressor ? &*compressor : nullptr;
+		auto const f = image_layout.formats[images.size()];
+		auto func = [i = std::move(image), c, f, &image_timer, this]() mutable {
+			auto ret = to_image_data(std::move(i), m_scene.m_gfx, c, f);
+			++m_status.done;
+			image_timer.mark();
+			return ret;
+		};
+		images.push_back(spawn(thread_pool, std::move(func)));
+	}
+
+	auto const texture_layout = TextureLayout::make(root, json, image_layout, sampler_ids);
+	m_status.done += root.textures.size() - texture_layout.unique.size();
+	auto texture_timer = StageTimer{};
+	auto textures = std::vector<Task<Texture>>{};
+	auto const textures_guard = WaitGuard{textures};
+	textures.reserve(texture_layout.unique.size());
+	for (auto const& entry : texture_layout.unique) {
+		auto& texture = root.textures[entry.texture];
+		auto tci = Texture::CreateInfo{
+			.name = std::move(texture.name),
+			.mip_mapped = !texture.linear,
+			.colour_space = texture.linear ? ColourSpace::eLinear : ColourSpace::eSrgb,
+			.stream = m_options.stream_textures,
+		};
+		auto func = [entry, tci = std::move(tci), &images, &get_sampler, &texture_timer, this] {
+			auto const sampler = get_sampler(entry.sampler);
+			auto ret = [&] {
+				for (auto const image : {entry.ktx2, entry.source}) {
+					if (!image || !images[*image].get().compressed) { continue; }
+					auto const& compressed = images[*image].get().compressed;
+					if (Texture::is_supported(m_scene.m_gfx, compressed->view())) { return Texture{m_scene.m_gfx, sampler, compressed, tci}; }
+					logger::warn("[GltfLoader] Compressed image format not supported by GPU: [{}]", compressed->name());
+				}
+				if (entry.source && images[*entry.source].get().staged) { return Texture{m_scene.m_gfx, sampler, images[*entry.source].get().staged, tci}; }
+				// invalid image: falls back to a (magenta) placeholder
+				return Texture{m_scene.m_gfx, sampler, Image::View{}, tci};
+			}();
+			++m_status.done;
+			texture_timer.mark();
+			return ret;
+		};
+		auto dependencies = std::vector<Task<ImageData>>{};
+		if (entry.ktx2) { dependencies.push_back(images[*entry.ktx2]); }
+		if (entry.source && entry.source != entry.ktx2) { dependencies.push_back(images[*entry.source]); }
+		if (dependencies.empty()) {
+			textures.push_back(spawn(thread_pool, std::move(func)));
+		} else {
+			textures.push_back(when_all(dependencies).then(std::move(func)));
+		}
+	}
+	if (images.size() < root.images.size() || textures.size() < root.textures.size() || m_scene.m_storage.resources.samplers.size() < root.samplers.size()) {
+		logger::info("[GltfLoader] Deduplicated images: [{}] => [{}], textures: [{}] => [{}], samplers: [{}] => [{}]", root.images.size(), images.size(),
+					 root.textures.size(), textures.size(), root.samplers.size(), m_scene.m_storage.resources.samplers.size());
 	}
 
+	// accessor data is decoded by the parser: each primitive is converted, processed, and uploaded by its own task
+	auto primitive_timer = StageTimer{};
 	auto mesh_primitives = std::vector<MaybeFuture<MeshPrimitive>>{};
 	auto mesh_layout = to_mesh_layout(root);
+	auto mesh_stats = MeshStats{};
+	auto const mesh_primitives_guard = WaitGuard{mesh_primitives};
 	mesh_primitives.reserve(mesh_layout.primitives.size());
 	for (auto& data : mesh_layout.data) {
 		for (auto [primitive, index] : enumerate(data.primitives)) {
-			auto name = fmt::format("{}_{}", data.name, index);
 			auto& p = mesh_layout.primitives[primitive.primitive];
-			mesh_primitives.push_back(make_load_future(thread_pool, m_status.done, [p = std::move(p), n = std::move(name), this] {
-				return MeshPrimitive{m_scene.m_gfx, p.geometry, {p.joints, p.weights}, std::move(n)};
-			}));
+			auto process = PrimitiveProcess::make(m_options, p, primitive.topology, fmt::format("{}_{}", data.name, index));
+			auto func = [p = std::move(p), process = std::move(process), &mesh_stats, &primitive_timer, this]() mutable {
+				auto layout = to_mesh_layout_primitive(std::move(p));
+				auto meshlets = process(layout, mesh_stats);
+				auto ret = MeshPrimitive{m_scene.m_gfx, layout.geometry, {layout.joints, layout.weights}, std::move(process.name), std::move(meshlets)};
+				primitive_timer.mark();
+				return ret;
+			};
+			mesh_primitives.push_back(make_load_future(thread_pool, m_status.done, std::move(func)));
 		}
 	}
 
-	for (auto& animation : root.animations) { m_scene.m_storage.resources.animations.m_array.push_back(to_animation(std::move(animation), root.accessors)); }
-	for (auto& skin : root.skins) { m_scene.m_storage.resources.skins.m_array.push_back(to_skin(std::move(skin), root.accessors)); }
-
-	m_scene.m_storage.resources.nodes.m_array = to_nodes(root.nodes);
-
-	m_scene.replace(from_maybe_futures(std::move(textures)));
+	// CPU conversions only read accessors and move out of their own arrays: they run alongside uploads
+	auto conversion_timer = StageTimer{};
+	auto animations = make_maybe_future(thread_pool, [&root, &conversion_timer] {
+		auto ret = std::vector<Animation>{};
+		ret.reserve(root.animations.size());
+		for (auto& animation : root.animations) { ret.push_back(to_animation(std::move(animation), root.accessors)); }
+		conversion_timer.mark();
+		return ret;
+	});
+	auto const animations_guard = WaitGuard{animations};
+	auto skins = make_maybe_future(thread_pool, [&root, &conversion_timer] {
+		auto ret = std::vector<Skin>{};
+		ret.reserve(root.skins.size());
+		for (auto& skin : root.skins) { ret.push_back(to_skin(std::move(skin), root.accessors)); }
+		conversion_timer.mark();
+		return ret;
+	});
+	auto const skins_guard = WaitGuard{skins};
+	auto nodes = make_maybe_future(thread_pool, [&root, &conversion_timer, thread_pool] {
+		auto ret = std::pair{to_nodes(root.nodes, thread_pool), to_node_data(root.nodes, thread_pool)};
+		conversion_timer.mark();
+		return ret;
+	});
+	auto const nodes_guard = WaitGuard{nodes};
+
+	// images without dependent textures must still complete: their tasks reference this frame
+	wait_on(images);
+	wait_on(textures);
+	auto texture_results = std::vector<Texture>{};
+	texture_results.reserve(textures.size());
+	for (auto& texture : textures) { texture_results.push_back(texture.take()); }
+	m_scene.replace(std::move(texture_results));
 	m_scene.replace(from_maybe_futures(std::move(mesh_primitives)));
+	mesh_stats.log();
 
 	m_status.stage = LoadStage::eBuildingScenes;
+	auto build_timer = StageTimer{};
+	m_scene.m_storage.resources.animations.m_array = animations.get();
+	m_scene.m_storage.resources.skins.m_array = skins.get();
+	auto [node_array, node_data] = nodes.get();
+	m_scene.m_storage.resources.nodes.m_array = std::move(node_array);
 	if (root.cameras.empty()) {
 		m_scene.add(Camera{.name = "default"});
 	} else {
 		for (auto gltf_camera : root.cameras) { m_scene.add(to_camera(std::move(gltf_camera))); }
 	}
-	for (auto const& material : root.materials) { m_scene.add(to_material(material)); }
+	for (auto const& material : root.materials) { m_scene.add(to_material(material, texture_layout.ids)); }
 	for (auto& data : mesh_layout.data) { m_scene.add(Mesh{.name = std::move(data.name), .primitives = std::move(data.primitives)}); }
 
-	m_scene.m_storage.data.nodes = to_node_data(root.nodes);
+	m_scene.m_storage.data.nodes = std::move(node_data);
 	for (auto& scene : root.scenes) {
 		auto& roots = m_scene.m_storage.data.trees.emplace_back();
 		for (auto id : scene.root_nodes) { roots.push_back(id); }
 	}
 
 	auto const ret = m_scene.load(root.start_scene.value_or(0));
+	build_timer.mark();
 	m_status.reset();
+
+	m_timings = LoadTimings{
+		.parse = parse_timer.elapsed(),
+		.images = image_timer.elapsed(),
+		.textures = texture_timer.elapsed(),
+		.primitives = primitive_timer.elapsed(),
+		.conversions = conversion_timer.elapsed(),
+		.build = build_timer.elapsed(),
+		.total = time::since_start() - start,
+	};
+	m_timings.log();
+	return ret;
+}
+
+bool Scene::GltfLoader::cook(char const* out_path, dj::Json const& json, DataProvider const& provider, LoadOptions const& options, ThreadPool* thread_pool,
+							 std::uint64_t source_stamp) noexcept(false) {
+	auto prefetch = UriPrefetch{json, provider, thread_pool};
+	auto get_bytes = [&prefetch](std::string_view uri) { return prefetch(uri); };
+
+	auto root = gltf2cpp::Parser{json}.parse(get_bytes);
+	if (!root || root.meshes.empty() || root.scenes.empty()) { return false; }
+	if (root.start_scene && *root.start_scene >= root.scenes.size()) { throw Error{fmt::format("Invalid start scene: {}", *root.start_scene)}; }
+
+	// no GPU to query: block compressed images are used as-is when loading if supported, else fall back to placeholders
+	auto const compressor = options.compress_textures ? std::optional<BlockCompressor>{std::in_place, options.texture_cache, thread_pool} : std::nullopt;
+	auto done = std::atomic<std::size_t>{};
+	auto const image_layout = ImageLayout::make(root);
+	auto image_futures = std::vector<MaybeFuture<ByteBuffer>>{};
+	auto const image_futures_guard = WaitGuard{image_futures};
+	for (auto [image, index] : enumerate(root.images)) {
+		if (image_layout.is_duplicate(index, image_futures.size())) { continue; }
+		auto const* c = compressor ? &*compressor : nullptr;
+		auto const f = image_layout.formats[image_futures.size()];
+		auto func = [i = std::move(image), c, f]() mutable { return to_ktx2(std::move(i), c, f); };
+		image_futures.push_back(make_load_future(thread_pool, done, std::move(func)));
+	}
+
+	auto ret = CookedScene{.source_stamp = source_stamp};
+	// samplers are deduplicated by Scene when the cooked scene is loaded
+	for (auto const& sampler : root.samplers) { ret.samplers.push_back(to_sampler_info(sampler)); }
+	auto sampler_ids = std::vector<std::size_t>(root.samplers.size());
+	std::iota(sampler_ids.begin(), sampler_ids.end(), std::size_t{});
+	auto const texture_layout = TextureLayout::make(root, json, image_layout, sampler_ids);
+	for (auto const& entry : texture_layout.unique) {
+		auto const& texture = root.textures[entry.texture];
+		auto cooked = CookedScene::Texture{
+			.name = texture.name,
+			.sampler = entry.sampler ? std::optional<std::uint32_t>{static_cast<std::uint32_t>(*entry.sampler)} : std::nullopt,
+			.colour_space = texture.linear ? ColourSpace::eLinear : ColourSpace::eSrgb,
+			.mip_mapped = !texture.linear,
+		};
+		for (auto const image : {entry.ktx2, entry.source}) {
+			if (image) { cooked.images.insert(static_cast<std::uint32_t>(*image)); }
+		}
+		ret.textures.push_back(std::move(cooked));
+	}
+
+	auto primitive_futures = std::vector<MaybeFuture<CookedPrimitive>>{};
+	auto mesh_layout = to_mesh_layout(root);
+	auto mesh_stats = MeshStats{};
+	auto const primitive_futures_guard = WaitGuard{primitive_futures};
+	for (auto& data : mesh_layout.data) {
+		for (auto [primitive, index] : enumerate(data.primitives)) {
+			auto& p = mesh_layout.primitives[primitive.primitive];
+			auto process = PrimitiveProcess::make(options, p, primitive.topology, fmt::format("{}_{}", data.name, index));
+			auto func = [p = std::move(p), process = std::move(process), &mesh_stats]() mutable {
+				auto layout = to_mesh_layout_primitive(std::move(p));
+				auto ret = CookedPrimitive{};
+				ret.primitive.meshlets = process(layout, mesh_stats);
+				ret.primitive.blob = MeshPrimitive::Blob::pack(ret.bytes, layout.geometry, {layout.joints, layout.weights});
+				ret.primitive.name = std::move(process.name);
+				return ret;
+			};
+			primitive_futures.push_back(make_load_future(thread_pool, done, std::move(func)));
+		}
+	}
+
+	for (auto gltf_camera : root.cameras) { ret.cameras.push_back(to_camera(std::move(gltf_camera))); }
+	for (auto const& material : root.materials) { ret.materials.push_back(to_material(material, texture_layout.ids)); }
+	for (auto& data : mesh_layout.data) { ret.meshes.push_back(Mesh{.name = std::move(data.name), .primitives = std::move(data.primitives)}); }
+	for (auto& skin : root.skins) { ret.skins.push_back(to_skin(std::move(skin), root.accessors)); }
+	for (auto& animation : root.animations) { ret.animations.push_back(to_animation(std::move(animation), root.accessors)); }
+	ret.nodes.resize(root.nodes.size());
+	parallel_for(thread_pool, root.nodes.size(), node_grain_v, [&root, &ret](std::size_t index) {
+		auto& in = root.nodes[index];
+		auto& node = ret.nodes[index];
+		for (float const weight : in.weights) {
+			if (node.weights.weights.size() < MorphWeights::max_weights_v) { node.weights.weights.insert(weight); }
+		}
+		node.data = to_node_data(std::move(in));
+		node.data.index = index;
+	});
+	for (auto const& scene : root.scenes) {
+		auto& roots = ret.trees.emplace_back();
+		for (auto id : scene.root_nodes) { roots.push_back(id); }
+	}
+	ret.start_tree = root.start_scene;
+
+	// payloads are views: the owning buffers must outlive the write
+	auto const images = from_maybe_futures(std::move(image_futures));
+	for (auto const& image : images) { ret.images.push_back(image.span()); }
+	auto const primitives = from_maybe_futures(std::move(primitive_futures));
+	for (auto const& primitive : primitives) { ret.primitives.push_back(primitive.primitive); }
+	mesh_stats.log();
+
+	if (!ret.write(out_path)) { return false; }
+	logger::info("[GltfLoader] Cooked scene: [{}]", out_path);
+	return true;
+}
+
+std::uint64_t Scene::GltfLoader::source_stamp(char const* path, dj::Json const& json, LoadOptions const& options) {
+	namespace fs = std::filesystem;
+	// texture_cache and stream_textures do not affect cooked data
+	auto ret = make_combined_hash(options.weld_vertices, options.optimize_meshes, options.build_meshlets, options.meshlet_min_triangles,
+								  options.compress_textures);
+	auto const add_time = [&ret](fs::path const& file) {
+		auto error = std::error_code{};
+		auto const time = fs::last_write_time(file, error);
+		// missing files fail the cook anyway (and data embedded in GLBs is covered by path)
+		if (!error) { hash_combine(ret, time.time_since_epoch().count()); }
+	};
+	auto const source = fs::path{path};
+	add_time(source);
+	auto const add_uris = [&](dj::Json const& array) {
+		for (auto const& item : array.array_view()) {
+			auto const& uri = item["uri"];
+			if (!uri || uri.as_string().starts_with("data:")) { continue; }
+			add_time(source.parent_path() / uri.as_string());
+		}
+	};
+	add_uris(json["buffers"]);
+	add_uris(json["images"]);
 	return ret;
 }
 } // namespace facade
@@ -54,4 +54,19 @@ void LitMaterial::write_sets(Pipeline& pipeline, TextureStore const& store) cons
 	pipeline.bind(set1);
 	pipeline.bind(set2);
 }
+
+FlexArray<Id<Texture>, 3> Material::textures() const {
+	auto ret = FlexArray<Id<Texture>, 3>{};
+	auto add = [&ret](std::optional<Id<Texture>> const& id) {
+		if (id) { ret.insert(*id); }
+	};
+	if (auto const* lit = std::get_if<LitMaterial>(&instance)) {
+		add(lit->base_colour);
+		add(lit->roughness_metallic);
+		add(lit->emissive);
+	} else if (auto const* unlit = std::get_if<UnlitMaterial>(&instance)) {
+		add(unlit->texture);
+	}
+	return ret;
+}
 } // namespace facade
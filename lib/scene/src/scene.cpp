@@ -76,8 +76,11 @@ Id<Camera> Scene::add(Camera camera) {
 }
 
 Id<Sampler> Scene::add(Sampler::CreateInfo const& create_info) {
+	auto const key = SamplerKey{create_info.mode_s, create_info.mode_t, create_info.min, create_info.mag};
+	if (auto const it = m_storage.samplers.find(key); it != m_storage.samplers.end()) { return it->second; }
 	auto const id = m_storage.resources.samplers.size();
 	m_storage.resources.samplers.m_array.emplace_back(m_gfx, create_info);
+	m_storage.samplers.emplace(key, id);
 	return id;
 }
 
@@ -166,11 +169,11 @@ Ptr<Node> Scene::parent(Id<Node> id) { return const_cast<Node*>(std::as_const(*t
 
 Texture Scene::make_texture(Image::View image) const { return Texture{m_gfx, default_sampler(), image}; }
 
-void Scene::tick(float dt) {
+void Scene::tick(float dt, ThreadPool* thread_pool) {
 	auto const nodes = m_storage.resources.nodes.view();
 	for (auto& animation : m_storage.resources.animations.view()) {
 		if (!animation.enabled()) { continue; }
-		animation.update(nodes, dt);
+		animation.update(nodes, dt, thread_pool);
 	}
 }
 
@@ -0,0 +1,52 @@
+#pragma once
+#include <facade/util/pinned.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+
+namespace facade {
+///
+/// \brief Writes a file through a temporary that is renamed over the target on commit: readers never observe partial files.
+///
+/// The temporary is removed if the instance is destroyed without a successful commit().
+///
+class AtomicFileWriter : public Pinned {
+  public:
+	///
+	/// \brief Construct an instance and open a temporary file next to path.
+	/// \param path Path of the file to write
+	///
+	/// The temporary is unique per thread: concurrent writers of the same path do not interfere (the last commit wins).
+	///
+	explicit AtomicFileWriter(std::string path);
+	~AtomicFileWriter();
+
+	///
+	/// \brief Append bytes to the file.
+	/// \param bytes Data to append
+	///
+	void write(std::span<std::byte const> bytes);
+	///
+	/// \brief Append zeros until offset bytes have been written.
+	/// \param offset Offset to pad to (ignored if already past it)
+	///
+	void pad_to(std::uint64_t offset);
+
+	///
+	/// \brief Close the temporary, check for write errors (buffered data is only flushed on close), and rename it over the target.
+	/// \returns true If the target was replaced
+	///
+	bool commit();
+
+	std::uint64_t written() const { return m_written; }
+
+  private:
+	std::string m_path{};
+	std::string m_temp{};
+	std::ofstream m_file{};
+	std::uint64_t m_written{};
+	bool m_committed{};
+};
+} // namespace facade
@@ -0,0 +1,68 @@
+#pragma once
+#include <facade/util/image.hpp>
+
+namespace facade {
+class ThreadPool;
+
+///
+/// \brief Encodes decoded images into GPU block compressed (KTX2) images, with an optional on-disk cache.
+///
+/// Colour data is encoded as BC7 (mode 6), two channel data as BC5; a full mip chain is generated for all formats.
+/// Cache entries are keyed by a hash of the source (PNG / JPG / etc) bytes and the target format.
+///
+class BlockCompressor {
+  public:
+	///
+	/// \brief Target block format.
+	///
+	enum class Format : std::uint8_t {
+		eBc7,
+		///
+		/// \brief Stores the G and B channels (roughness-metallic), swizzled back into place on sampling.
+		///
+		eBc5,
+		///
+		/// \brief Stores uncompressed RGBA, for GPUs without BCn support / cooking ready-to-upload mip chains.
+		///
+		eRgba8,
+	};
+
+	///
+	/// \brief Hash bytes (FNV-1a).
+	/// \param bytes Data to hash
+	/// \returns 64-bit hash
+	///
+	static std::uint64_t hash(std::span<std::byte const> bytes);
+
+	///
+	/// \brief Encode an RGBA image and its (box filtered) mip chain.
+	/// \param image Image to encode
+	/// \param format Target block format
+	/// \param pool Pool to encode block rows on (encodes serially if null)
+	/// \returns KTX2 file data (empty if image is invalid)
+	///
+	static ByteBuffer encode(Image::View image, Format format, ThreadPool* pool = {});
+
+	///
+	/// \brief Construct an instance.
+	/// \param cache_directory Directory to cache encoded images in (caching is disabled if empty)
+	/// \param pool Pool to encode block rows on (encodes serially if null)
+	///
+	explicit BlockCompressor(std::string cache_directory = {}, ThreadPool* pool = {});
+
+	std::string_view cache_directory() const { return m_cache_directory; }
+
+	///
+	/// \brief Obtain a block compressed image from the cache, or decode, encode, and cache it.
+	/// \param source Compressed image data (PNG, JPG, TGA, etc)
+	/// \param format Target block format
+	/// \param name Name of the image (optional)
+	/// \returns Compressed image (empty if source could not be decoded)
+	///
+	CompressedImage operator()(std::span<std::byte const> source, Format format, std::string name = {}) const;
+
+  private:
+	std::string m_cache_directory{};
+	ThreadPool* m_pool{};
+};
+} // namespace facade
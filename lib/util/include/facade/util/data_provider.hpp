@@ -1,8 +1,59 @@
 #pragma once
 #include <facade/util/byte_buffer.hpp>
+#include <facade/util/mapped_file.hpp>
+#include <algorithm>
+#include <cassert>
+#include <memory>
 #include <string>
 
 namespace facade {
+///
+/// \brief Read-only view into data, sharing ownership of its storage (a heap buffer or a file mapping).
+///
+class DataView {
+  public:
+	DataView() = default;
+
+	///
+	/// \brief Construct an instance owning a heap buffer.
+	/// \param buffer Buffer to own and view
+	///
+	explicit DataView(ByteBuffer buffer);
+	///
+	/// \brief Construct an instance owning a file mapping.
+	/// \param file Mapped file to own and view
+	///
+	explicit DataView(MappedFile file);
+	///
+	/// \brief Construct an instance viewing bytes within storage.
+	/// \param bytes Bytes to view
+	/// \param storage Storage backing bytes, kept alive while viewed
+	///
+	explicit DataView(std::span<std::byte const> bytes, std::shared_ptr<void const> storage) : m_storage(std::move(storage)), m_bytes(bytes) {}
+
+	std::span<std::byte const> bytes() const { return m_bytes; }
+	explicit operator bool() const { return !m_bytes.empty(); }
+
+	///
+	/// \brief Obtain a view into a subrange of the bytes, sharing ownership of the storage.
+	/// \param offset Offset of the first byte (must be in range)
+	/// \param size Number of bytes (must be in range)
+	/// \returns DataView into the subrange
+	///
+	/// Out of range subranges assert, and are clamped to the bytes in range in release builds.
+	///
+	DataView subview(std::size_t offset, std::size_t size) const {
+		assert(offset <= m_bytes.size() && size <= m_bytes.size() - offset);
+		offset = std::min(offset, m_bytes.size());
+		size = std::min(size, m_bytes.size() - offset);
+		return DataView{m_bytes.subspan(offset, size), m_storage};
+	}
+
+  private:
+	std::shared_ptr<void const> m_storage{};
+	std::span<std::byte const> m_bytes{};
+};
+
 ///
 /// \brief Pure virtual interface for a data provider that returns bytes given a (relative) URI.
 ///
@@ -14,6 +65,15 @@ struct DataProvider {
 	/// \returns An empty ByteBuffer if not found
 	///
 	virtual ByteBuffer load(std::string_view uri) const = 0;
+	///
+	/// \brief Obtain a read-only view of the data located at uri.
+	/// \param uri The URI to view
+	/// \returns An empty DataView if not found
+	///
+	/// The default implementation views a loaded heap buffer; overrides avoid the copy where possible.
+	/// Used for GLB containers, pack files, and skybox images: the GLTF parser takes ownership of buffers and uses load().
+	///
+	virtual DataView view(std::string_view uri) const { return DataView{load(uri)}; }
 };
 
 ///
@@ -35,6 +95,12 @@ class FileDataProvider : public DataProvider {
 	FileDataProvider(std::string_view directory);
 
 	ByteBuffer load(std::string_view uri) const override;
+	///
+	/// \brief Map the file located at uri (read-only), hinting sequential access.
+	///
+	/// Pages are read ahead by the OS and shared with its file cache: nothing is copied into heap memory.
+	///
+	DataView view(std::string_view uri) const override;
 
 	///
 	/// \brief Check if this instance has a root / prefix mounted.
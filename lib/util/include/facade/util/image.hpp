@@ -1,8 +1,11 @@
 #pragma once
+#include <facade/util/byte_buffer.hpp>
 #include <facade/util/unique.hpp>
 #include <glm/vec2.hpp>
+#include <array>
 #include <span>
 #include <string>
+#include <vector>
 
 namespace facade {
 constexpr std::byte operator""_B(unsigned long long l) { return static_cast<std::byte>(l); }
@@ -22,6 +25,22 @@ class Image {
 		glm::uvec2 extent{};
 	};
 
+	///
+	/// \brief Obtain the extent of compressed image data without decompressing it.
+	/// \param compressed Image data (compressed)
+	/// \returns Extent of the image (zero if unsupported)
+	///
+	static glm::uvec2 peek(std::span<std::byte const> compressed);
+	///
+	/// \brief Decompress image data (PNG, JPG, TGA, etc) as RGBA into caller provided memory.
+	/// \param compressed Image data (compressed)
+	/// \param out_rgba Destination, at least 4 bytes per pixel of the extent returned by peek()
+	/// \returns false if decompression failed or out_rgba is too small
+	///
+	/// Pixels are written sequentially and never read back, out_rgba can be write-combined (mapped GPU) memory.
+	///
+	static bool decode(std::span<std::byte const> compressed, std::span<std::byte> out_rgba);
+
 	Image() = default;
 
 	///
@@ -67,6 +86,95 @@ class Image {
 	glm::uvec2 m_extent{};
 };
 
+///
+/// \brief Storage for GPU compressed (BCn / ETC2 / ASTC) image data with pre-built mip levels.
+///
+/// Loaded from KTX2 containers; payloads are uploaded as-is, without any CPU decoding.
+///
+class CompressedImage {
+  public:
+	///
+	/// \brief A single mip level.
+	///
+	struct Level {
+		std::span<std::byte const> bytes{};
+		glm::uvec2 extent{};
+	};
+
+	///
+	/// \brief View into an image.
+	///
+	/// Must not outlive the image.
+	///
+	struct View {
+		std::span<Level const> levels{};
+		///
+		/// \brief VkFormat of the payload.
+		///
+		std::uint32_t vk_format{};
+		///
+		/// \brief Channel mapping (from KTXswizzle): one of 'r', 'g', 'b', 'a', '0', '1' per channel.
+		///
+		std::array<char, 4> swizzle{'r', 'g', 'b', 'a'};
+	};
+
+	///
+	/// \brief Check if data is a KTX2 container.
+	/// \param bytes Data to check
+	/// \returns true if data starts with the KTX2 identifier
+	///
+	static bool is_ktx2(std::span<std::byte const> bytes);
+
+	CompressedImage() = default;
+
+	///
+	/// \brief Construct an instance from a KTX2 container.
+	/// \param ktx2 KTX2 file data
+	/// \param name Name of the image (optional)
+	///
+	/// Only 2D, single layer, non-supercompressed images are supported: Basis Universal payloads
+	/// (BasisLZ / UASTC) require a transcoder and result in an empty instance.
+	///
+	explicit CompressedImage(std::span<std::byte const> ktx2, std::string name = {});
+	///
+	/// \brief Construct an instance from a KTX2 container, taking ownership of the data.
+	/// \param ktx2 KTX2 file data
+	/// \param name Name of the image (optional)
+	///
+	explicit CompressedImage(ByteBuffer ktx2, std::string name = {});
+
+	///
+	/// \brief Obtain a view into the stored image.
+	/// \returns View into the image
+	///
+	View view() const { return {.levels = m_levels, .vk_format = m_vk_format, .swizzle = m_swizzle}; }
+	///
+	/// \brief Obtain the name.
+	/// \returns The name
+	///
+	std::string_view name() const { return m_name; }
+	///
+	/// \brief Obtain the KTX2 container data.
+	/// \returns View into the KTX2 file data
+	///
+	std::span<std::byte const> ktx2() const { return m_bytes.span(); }
+
+	operator View() const { return view(); }
+
+	///
+	/// \brief Check if any image data is stored in this instance.
+	/// \returns true If at least one mip level is present
+	///
+	explicit operator bool() const { return !m_levels.empty(); }
+
+  private:
+	std::string m_name{};
+	ByteBuffer m_bytes{};
+	std::vector<Level> m_levels{};
+	std::uint32_t m_vk_format{};
+	std::array<char, 4> m_swizzle{'r', 'g', 'b', 'a'};
+};
+
 template <std::uint32_t Width, std::uint32_t Height, std::uint32_t Channels = 4>
 struct FixedBitmap {
 	std::byte bytes[Width * Height * Channels]{};
@@ -2,6 +2,8 @@
 #include <fmt/format.h>
 #include <facade/defines.hpp>
 #include <facade/util/pinned.hpp>
+#include <atomic>
+#include <cstdint>
 #include <span>
 
 namespace facade::logger {
@@ -14,6 +16,17 @@ enum class Pipe : std::uint8_t { eStdOut, eStdErr };
 ///
 enum class Level : std::uint8_t { eError, eWarn, eInfo, eDebug, eCOUNT_ };
 inline constexpr char levels_v[] = {'E', 'W', 'I', 'D'};
+///
+/// \brief A destination of log messages.
+///
+enum class Sink : std::uint8_t { eConsole, eFile, eBuffer, eCOUNT_ };
+
+///
+/// \brief Most verbose level logged to any sink: messages above this are discarded before being formatted.
+///
+/// Maintained by set_level(), do not modify directly.
+///
+inline std::atomic<Level> g_max_level{Level::eDebug};
 
 ///
 /// \brief The format for a log message.
@@ -28,32 +41,80 @@ struct Entry {
 	Level level{};
 };
 
+///
+/// \brief A log message entry stored in the log buffer.
+///
+/// Messages are copied into fixed-size storage: longer messages are truncated (and end with "...").
+///
+struct BufferEntry {
+	///
+	/// \brief Maximum length of a stored message (excluding the null terminator).
+	///
+	static constexpr std::size_t max_length_v{255};
+
+	char message[max_length_v + 1]{};
+	Level level{};
+
+	char const* c_str() const { return message; }
+};
+
 ///
 /// \brief Size of the buffer for stored logs.
 ///
 struct BufferSize {
 	///
-	/// \brief Lower threshold: will shrink down to this size.
+	/// \brief Maximum number of entries: once full, each new entry overwrites the oldest one.
 	///
-	std::size_t limit{500};
+	/// All entries are allocated up front, logging never allocates buffer memory.
 	///
-	/// \brief Extra space beyond lower threshold: crossing this will trigger a shrink.
-	///
-	std::size_t delta{100};
+	std::size_t capacity{600};
+};
 
+///
+/// \brief View into the entries stored in the log buffer, oldest first.
+///
+/// The ring buffer wraps around: entries are split into two contiguous spans.
+///
+struct BufferView {
+	std::span<BufferEntry const> first{};
+	std::span<BufferEntry const> second{};
 	///
-	/// \brief Total size of the buffer.
+	/// \brief Number of entries overwritten since the buffer was initialized.
 	///
-	constexpr std::size_t total() const { return limit + delta; }
+	std::uint64_t dropped{};
+
+	std::size_t size() const { return first.size() + second.size(); }
+	BufferEntry const& operator[](std::size_t index) const { return index < first.size() ? first[index] : second[index - first.size()]; }
 };
 
 ///
 /// \brief Pure virtual interface for concurrent access to the entries stored in the log buffer
 ///
+/// The view is only valid (and entries are only left unmodified) during the call.
+///
 struct Accessor {
-	virtual void operator()(std::span<Entry const> entries) = 0;
+	virtual void operator()(BufferView const& entries) = 0;
 };
 
+///
+/// \brief Set the most verbose level logged to a sink.
+/// \param sink The sink to set the level of
+/// \param level Messages with a more verbose level are not logged to sink
+///
+void set_level(Sink sink, Level level);
+///
+/// \brief Obtain the most verbose level logged to a sink.
+/// \param sink The sink to query
+/// \returns The most verbose level logged to sink
+///
+Level level(Sink sink);
+///
+/// \brief Check if messages of a level are logged to any sink.
+/// \param level The level to check
+/// \returns true If at least one sink logs messages of level
+///
+inline bool enabled(Level level) { return level <= g_max_level.load(std::memory_order_relaxed); }
+
 ///
 /// \brief Obtain the current thread ID.
 /// \returns The thread ID
@@ -72,6 +133,8 @@ std::string format(Level level, std::string_view const message);
 /// \param pipe The pipe to log the text through
 /// \param entry The log message entry
 ///
+/// The entry is only written to sinks whose level includes that of the entry.
+///
 void log_to(Pipe pipe, Entry entry);
 ///
 /// \brief Obtain the log buffer size.
@@ -91,7 +154,7 @@ class Instance : public Pinned {
   public:
 	///
 	/// \brief Initialize the log buffer.
-	/// \param buffer_size Desired size of the log buffer
+	/// \param buffer_size Desired capacity of the log buffer
 	///
 	Instance(BufferSize const& buffer_size = {});
 	~Instance();
@@ -116,6 +179,7 @@ std::string format(Level level, fmt::format_string<Args...> fmt, Args const&...
 ///
 template <typename... Args>
 void error(fmt::format_string<Args...> fmt, Args const&... args) {
+	if (!enabled(Level::eError)) { return; }
 	log_to(Pipe::eStdErr, {format(Level::eError, fmt, args...), Level::eError});
 }
 
@@ -126,6 +190,7 @@ void error(fmt::format_string<Args...> fmt, Args const&... args) {
 ///
 template <typename... Args>
 void warn(fmt::format_string<Args...> fmt, Args const&... args) {
+	if (!enabled(Level::eWarn)) { return; }
 	log_to(Pipe::eStdOut, {format(Level::eWarn, fmt, args...), Level::eWarn});
 }
 
@@ -136,6 +201,7 @@ void warn(fmt::format_string<Args...> fmt, Args const&... args) {
 ///
 template <typename... Args>
 void info(fmt::format_string<Args...> fmt, Args const&... args) {
+	if (!enabled(Level::eInfo)) { return; }
 	log_to(Pipe::eStdOut, {format(Level::eInfo, fmt, args...), Level::eInfo});
 }
 
@@ -146,6 +212,9 @@ void info(fmt::format_string<Args...> fmt, Args const&... args) {
 ///
 template <typename... Args>
 void debug(fmt::format_string<Args...> fmt, Args const&... args) {
-	if constexpr (debug_v) { log_to(Pipe::eStdOut, {format(Level::eDebug, fmt, args...), Level::eDebug}); }
+	if constexpr (debug_v) {
+		if (!enabled(Level::eDebug)) { return; }
+		log_to(Pipe::eStdOut, {format(Level::eDebug, fmt, args...), Level::eDebug});
+	}
 }
 } // namespace facade::logger
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace facade::lz4 {
+///
+/// \brief Obtain the worst case compressed size of size bytes.
+///
+constexpr std::size_t max_compressed_size(std::size_t size) { return size + size / 255 + 16; }
+
+///
+/// \brief Compress bytes into a single LZ4 block (greedy, fast mode).
+/// \param bytes Data to compress
+/// \returns LZ4 block data
+///
+std::vector<std::byte> compress(std::span<std::byte const> bytes);
+
+///
+/// \brief Decompress a single LZ4 block.
+/// \param block LZ4 block data
+/// \param out_bytes Destination, sized to exactly the uncompressed size
+/// \returns true If block was valid and decompressed into exactly out_bytes.size() bytes
+///
+bool decompress(std::span<std::byte const> block, std::span<std::byte> out_bytes);
+} // namespace facade::lz4
@@ -0,0 +1,61 @@
+#pragma once
+#include <facade/util/unique.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace facade {
+///
+/// \brief Read-only memory mapping of an entire file.
+///
+/// Pages are faulted in by the OS on first access, nothing is read up front.
+///
+class MappedFile {
+  public:
+	///
+	/// \brief Expected access pattern, passed on to the OS as a hint.
+	///
+	enum class Access : std::uint8_t {
+		eDefault,
+		///
+		/// \brief Read front to back soon: aggressive read-ahead, and paging in starts immediately.
+		///
+		eSequential,
+	};
+
+	MappedFile() = default;
+
+	///
+	/// \brief Construct an instance and map a file.
+	/// \param path Path to the file to map
+	/// \param access Expected access pattern
+	///
+	/// Failure to open / map the file results in an empty instance.
+	///
+	explicit MappedFile(char const* path, Access access = Access::eDefault);
+
+	///
+	/// \brief Obtain the mapped bytes.
+	/// \returns View into the mapped file
+	///
+	std::span<std::byte const> bytes() const { return {m_mapping.get().data, m_mapping.get().size}; }
+
+	///
+	/// \brief Check if a file is mapped.
+	/// \returns true If a (non-empty) file is mapped
+	///
+	explicit operator bool() const { return m_mapping.get().data != nullptr; }
+
+  private:
+	struct Mapping {
+		std::byte const* data{};
+		std::size_t size{};
+
+		struct Deleter {
+			void operator()(Mapping const& mapping) const;
+		};
+	};
+
+	Unique<Mapping, Mapping::Deleter> m_mapping{};
+};
+} // namespace facade
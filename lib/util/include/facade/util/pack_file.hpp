@@ -0,0 +1,170 @@
+#pragma once
+#include <facade/util/data_provider.hpp>
+#include <facade/util/mapped_file.hpp>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace facade {
+class ThreadPool;
+
+///
+/// \brief Single file archive of entries indexed by URI, each optionally LZ4 compressed.
+///
+/// Layout: header, index (sorted by URI), URI strings, then 16 byte aligned entry data.
+/// Compressed entries are split into independently compressed chunks (preceded by a table of their sizes),
+/// which can be decompressed in parallel.
+///
+class PackFile {
+  public:
+	///
+	/// \brief File extension of pack files.
+	///
+	static constexpr std::string_view extension_v{".fpk"};
+	///
+	/// \brief Uncompressed size of each compressed chunk (except the last).
+	///
+	static constexpr std::size_t chunk_size_v{256 * 1024};
+
+	enum class Compression : std::uint8_t { eNone, eLz4 };
+
+	///
+	/// \brief Builds a pack file in memory.
+	///
+	class Writer {
+	  public:
+		///
+		/// \brief Add an entry.
+		/// \param uri URI of the entry (relative path, '/' separated)
+		/// \param bytes Data of the entry
+		/// \param compression Compression to attempt (entries that do not shrink are stored uncompressed)
+		///
+		/// This function purposely throws on unknown compression values.
+		///
+		void add(std::string uri, std::span<std::byte const> bytes, Compression compression = Compression::eNone) noexcept(false);
+
+		///
+		/// \brief Set the URI of the root entry (eg the GLTF JSON).
+		///
+		void set_root(std::string uri) { m_root = std::move(uri); }
+
+		///
+		/// \brief Write all entries to a file.
+		/// \param path Path to write to
+		/// \returns true If successfully written
+		///
+		bool write(char const* path) const;
+
+	  private:
+		struct Entry {
+			std::string uri{};
+			std::vector<std::byte> data{};
+			std::uint64_t size{};
+			Compression compression{};
+		};
+
+		std::vector<Entry> m_entries{};
+		std::string m_root{};
+	};
+
+	PackFile() = default;
+
+	///
+	/// \brief Map a pack file.
+	/// \param path Path to the pack file
+	///
+	/// Failure to map or validate the file results in an empty instance.
+	///
+	explicit PackFile(char const* path);
+
+	///
+	/// \brief Check if a file is a pack file.
+	/// \param bytes (Start of the) file data
+	/// \returns true If bytes start with a valid header
+	///
+	static bool is_pack(std::span<std::byte const> bytes);
+
+	///
+	/// \brief Obtain the URI of the root entry (empty if not set).
+	///
+	std::string_view root() const { return m_root; }
+	///
+	/// \brief Obtain the number of entries.
+	///
+	std::size_t size() const { return m_index.size(); }
+
+	///
+	/// \brief Check if an entry exists.
+	///
+	bool contains(std::string_view uri) const { return find(uri) != nullptr; }
+
+	///
+	/// \brief Obtain a view into an uncompressed entry's data, within the mapping.
+	/// \param uri URI of the entry
+	/// \returns Empty span if not found or compressed
+	///
+	std::span<std::byte const> stored(std::string_view uri) const;
+
+	///
+	/// \brief Load an entry's data into a heap buffer, decompressing if necessary.
+	/// \param uri URI of the entry
+	/// \param thread_pool Optional thread pool to decompress chunks on in parallel
+	/// \returns Empty ByteBuffer if not found or corrupt
+	///
+	ByteBuffer load(std::string_view uri, ThreadPool* thread_pool = {}) const;
+
+	explicit operator bool() const { return static_cast<bool>(m_file); }
+
+  private:
+	struct Entry {
+		std::uint64_t uri_offset{};
+		std::uint64_t offset{};
+		std::uint64_t stored_size{};
+		std::uint64_t size{};
+		std::uint32_t uri_size{};
+		Compression compression{};
+		std::uint8_t padding[3]{};
+	};
+
+	Entry const* find(std::string_view uri) const;
+	std::string_view uri(Entry const& entry) const;
+
+	MappedFile m_file{};
+	std::span<Entry const> m_index{};
+	std::span<char const> m_strings{};
+	std::span<std::byte const> m_data{};
+	std::string_view m_root{};
+};
+
+///
+/// \brief Concrete DataProvider that reads entries from a pack file.
+///
+/// Replaces per-file open / stat calls with lookups in the mapped index.
+///
+class PackDataProvider : public DataProvider {
+  public:
+	///
+	/// \brief Construct an instance and map a pack file.
+	/// \param path Path to the pack file
+	/// \param thread_pool Optional thread pool to decompress entries on in parallel (must outlive this instance)
+	///
+	explicit PackDataProvider(char const* path, ThreadPool* thread_pool = {});
+
+	ByteBuffer load(std::string_view uri) const override;
+	///
+	/// \brief Obtain a view into an entry: uncompressed entries are viewed within the mapping, compressed ones are decompressed into a heap buffer.
+	///
+	DataView view(std::string_view uri) const override;
+
+	PackFile const& pack() const { return *m_pack; }
+
+	explicit operator bool() const { return static_cast<bool>(*m_pack); }
+
+  private:
+	// shared with views of stored entries
+	std::shared_ptr<PackFile const> m_pack{};
+	ThreadPool* m_thread_pool{};
+};
+} // namespace facade
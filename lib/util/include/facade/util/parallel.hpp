@@ -0,0 +1,150 @@
+#pragma once
+#include <facade/util/thread_pool.hpp>
+#include <algorithm>
+#include <exception>
+#include <ranges>
+
+namespace facade {
+///
+/// \brief Number of chunks per thread (including the calling one) when the grain size is automatic.
+///
+/// More chunks than threads balance uneven per-index costs: threads that finish early claim more chunks.
+///
+inline constexpr std::size_t chunks_per_thread_v{4};
+
+///
+/// \brief Obtain the automatic grain size for a range.
+/// \param count Number of indices in the range
+/// \param threads Number of threads running chunks (including the calling one)
+/// \returns Number of indices per chunk
+///
+constexpr std::size_t auto_grain(std::size_t count, std::size_t threads) {
+	auto const chunks = std::max(threads, std::size_t{1}) * chunks_per_thread_v;
+	return std::max(count / chunks, std::size_t{1});
+}
+
+///
+/// \brief Invoke a callable on contiguous chunks of an index range on a thread pool, blocking until all chunks have completed.
+/// \param pool Pool to run on (runs serially on the calling thread if null or without workers)
+/// \param count Number of indices in the range [0, count)
+/// \param grain Number of indices per chunk (automatic if 0)
+/// \param func Callable of signature void(std::size_t begin, std::size_t end)
+/// \param priority Priority of the pool tasks (inherited if unset)
+///
+/// The calling thread runs chunks too; ranges that fit in a single chunk run serially without touching the pool.
+/// If func throws, remaining chunks are skipped and the first exception is rethrown on the calling thread.
+/// This function purposely rethrows any exception thrown by func.
+///
+template <typename F>
+void parallel_chunks(ThreadPool* pool, std::size_t count, std::size_t grain, F func, std::optional<ThreadPool::Priority> priority = {}) noexcept(false) {
+	if (count == 0) { return; }
+	auto const workers = pool ? pool->thread_count() : std::size_t{};
+	if (grain == 0) { grain = auto_grain(count, workers + 1); }
+	auto const chunks = (count + grain - 1) / grain;
+	if (workers == 0 || chunks < 2) {
+		func(std::size_t{}, count);
+		return;
+	}
+
+	struct Shared {
+		std::atomic<std::size_t> next{};
+		std::atomic<std::size_t> done{};
+		std::atomic<bool> failed{};
+		std::exception_ptr error{};
+		std::mutex mutex{};
+	};
+	auto shared = std::make_shared<Shared>();
+	// func is only accessed after claiming a chunk: the calling thread waits for all claimed chunks, so late tasks never touch it
+	auto run = [shared, chunks, count, grain, f = &func] {
+		for (auto chunk = shared->next++; chunk < chunks; chunk = shared->next++) {
+			if (!shared->failed) {
+				try {
+					auto const begin = chunk * grain;
+					(*f)(begin, std::min(begin + grain, count));
+				} catch (...) {
+					auto lock = std::scoped_lock{shared->mutex};
+					if (!shared->error) { shared->error = std::current_exception(); }
+					shared->failed = true;
+				}
+			}
+			if (++shared->done == chunks) { shared->done.notify_all(); }
+		}
+	};
+	for (std::size_t i = 0; i < std::min(chunks - 1, workers); ++i) { pool->post(run, priority); }
+	run();
+	// all chunks have been claimed: the rest are running on other threads, nothing left to help with
+	for (auto done = shared->done.load(); done < chunks; done = shared->done.load()) { shared->done.wait(done); }
+	if (shared->error) { std::rethrow_exception(shared->error); }
+}
+
+///
+/// \brief Invoke a callable for each index in a range on a thread pool, blocking until all have completed.
+/// \param pool Pool to run on (runs serially on the calling thread if null or without workers)
+/// \param count Number of indices in the range [0, count)
+/// \param grain Number of indices per chunk (automatic if 0)
+/// \param func Callable of signature void(std::size_t index)
+/// \param priority Priority of the pool tasks (inherited if unset)
+///
+/// This function purposely rethrows the first exception thrown by func.
+///
+template <typename F>
+	requires(std::invocable<F&, std::size_t>)
+void parallel_for(ThreadPool* pool, std::size_t count, std::size_t grain, F func, std::optional<ThreadPool::Priority> priority = {}) noexcept(false) {
+	parallel_chunks(
+		pool, count, grain,
+		[&func](std::size_t begin, std::size_t end) {
+			for (; begin < end; ++begin) { func(begin); }
+		},
+		priority);
+}
+
+///
+/// \brief Invoke a callable for each element of a random access range on a thread pool, blocking until all have completed.
+/// \param pool Pool to run on (runs serially on the calling thread if null or without workers)
+/// \param range Range of elements
+/// \param grain Number of elements per chunk (automatic if 0)
+/// \param func Callable taking an element of range
+/// \param priority Priority of the pool tasks (inherited if unset)
+///
+/// This function purposely rethrows the first exception thrown by func.
+///
+template <std::ranges::random_access_range R, typename F>
+	requires(std::ranges::sized_range<R> && std::invocable<F&, std::ranges::range_reference_t<R>>)
+void parallel_for(ThreadPool* pool, R&& range, std::size_t grain, F func, std::optional<ThreadPool::Priority> priority = {}) noexcept(false) {
+	auto const first = std::ranges::begin(range);
+	parallel_for(
+		pool, std::ranges::size(range), grain, [first, &func](std::size_t index) { func(first[static_cast<std::ranges::range_difference_t<R>>(index)]); },
+		priority);
+}
+
+///
+/// \brief Map each index in a range to a value and reduce them on a thread pool.
+/// \param pool Pool to run on (runs serially on the calling thread if null or without workers)
+/// \param count Number of indices in the range [0, count)
+/// \param grain Number of indices per chunk (automatic if 0)
+/// \param identity Initial value of each chunk (must be the identity of reduce)
+/// \param map Callable of signature T(std::size_t index)
+/// \param reduce Associative callable of signature T(T, T)
+/// \param priority Priority of the pool tasks (inherited if unset)
+/// \returns Reduced value
+///
+/// Chunks are reduced in index order once all have completed, so the result does not depend on scheduling.
+/// This function purposely rethrows the first exception thrown by map or reduce.
+///
+template <typename T, typename Map, typename Reduce>
+T parallel_reduce(ThreadPool* pool, std::size_t count, std::size_t grain, T identity, Map map, Reduce reduce,
+				  std::optional<ThreadPool::Priority> priority = {}) noexcept(false) {
+	if (count == 0) { return identity; }
+	if (grain == 0) { grain = auto_grain(count, (pool ? pool->thread_count() : 0) + 1); }
+	auto partials = std::vector<T>((count + grain - 1) / grain, identity);
+	parallel_chunks(
+		pool, count, grain,
+		[&](std::size_t begin, std::size_t end) {
+			auto& partial = partials[begin / grain];
+			for (; begin < end; ++begin) { partial = reduce(std::move(partial), map(begin)); }
+		},
+		priority);
+	for (auto& partial : partials) { identity = reduce(std::move(identity), std::move(partial)); }
+	return identity;
+}
+} // namespace facade
@@ -0,0 +1,172 @@
+#pragma once
+#include <facade/util/pinned.hpp>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stop_token>
+#include <vector>
+
+namespace facade {
+///
+/// \brief Bounded lock-free multi-producer, multi-consumer FIFO queue (Vyukov).
+///
+/// Each slot carries a sequence number that tells producers and consumers whether it is free or filled for their turn:
+/// pushing and popping claim a position with a single CAS, no locks are taken.
+/// Blocking push / pop sleep on std::atomic::wait, producers / consumers only notify when the other side has registered as waiting.
+///
+template <typename Type>
+class RingQueue : public Pinned {
+  public:
+	///
+	/// \brief Construct a RingQueue.
+	/// \param capacity Maximum number of items (rounded up to a power of 2)
+	///
+	explicit RingQueue(std::size_t capacity = 1024) : m_cells(std::bit_ceil(std::max(capacity, std::size_t{2}))), m_mask(m_cells.size() - 1) {
+		for (std::size_t i = 0; i < m_cells.size(); ++i) { m_cells[i].sequence.store(i, std::memory_order_relaxed); }
+	}
+
+	~RingQueue() {
+		while (try_pop()) {}
+	}
+
+	std::size_t capacity() const { return m_cells.size(); }
+
+	///
+	/// \brief Try to enqueue an item: non-blocking
+	/// \param t Item to push (only moved from on success)
+	/// \returns false if queue is full
+	///
+	bool try_push(Type&& t) {
+		auto pos = m_push.load(std::memory_order_relaxed);
+		Cell* cell{};
+		for (;;) {
+			cell = &m_cells[pos & m_mask];
+			auto const seq = cell->sequence.load(std::memory_order_acquire);
+			auto const diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+			if (diff == 0) {
+				if (m_push.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+			} else if (diff < 0) {
+				return false;
+			} else {
+				pos = m_push.load(std::memory_order_relaxed);
+			}
+		}
+		new (cell->storage) Type(std::move(t));
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		m_pushed.signal();
+		return true;
+	}
+
+	///
+	/// \brief Try to dequeue an item: non-blocking
+	/// \returns std::nullopt if queue is empty, else the front
+	///
+	std::optional<Type> try_pop() {
+		auto pos = m_pop.load(std::memory_order_relaxed);
+		Cell* cell{};
+		for (;;) {
+			cell = &m_cells[pos & m_mask];
+			auto const seq = cell->sequence.load(std::memory_order_acquire);
+			auto const diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+			if (diff == 0) {
+				if (m_pop.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+			} else if (diff < 0) {
+				return {};
+			} else {
+				pos = m_pop.load(std::memory_order_relaxed);
+			}
+		}
+		auto* item = std::launder(reinterpret_cast<Type*>(cell->storage));
+		auto ret = std::optional<Type>{std::move(*item)};
+		item->~Type();
+		cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+		m_popped.signal();
+		return ret;
+	}
+
+	///
+	/// \brief Push t to the back, blocking while the queue is full
+	///
+	void push(Type t) {
+		if (try_push(std::move(t))) { return; }
+		m_popped.wait_until([&] { return try_push(std::move(t)); });
+	}
+
+	///
+	/// \brief Try to dequeue an item: blocking
+	/// \returns std::nullopt if stop has been requested, else the front
+	///
+	std::optional<Type> pop(std::stop_token const& stop) {
+		auto ret = std::optional<Type>{};
+		if (stop.stop_requested()) { return ret; }
+		if ((ret = try_pop())) { return ret; }
+		auto const wake = std::stop_callback{stop, [this] { ping(); }};
+		m_pushed.wait_until([&] { return stop.stop_requested() || (ret = try_pop()); });
+		return ret;
+	}
+
+	///
+	/// \brief Notify all sleeping consumers
+	///
+	void ping() {
+		++m_pushed.epoch;
+		m_pushed.epoch.notify_all();
+	}
+
+	///
+	/// \brief Empty the queue, notify all sleeping consumers, and return the items
+	/// \returns Items left in the queue
+	///
+	std::vector<Type> release() {
+		auto ret = std::vector<Type>{};
+		while (auto t = try_pop()) { ret.push_back(std::move(*t)); }
+		ping();
+		return ret;
+	}
+
+  private:
+	static constexpr std::size_t cache_line_v{64};
+
+	struct Cell {
+		std::atomic<std::size_t> sequence{};
+		alignas(Type) std::byte storage[sizeof(Type)];
+	};
+
+	// waiters sleep until the epoch changes: the side making progress bumps it
+	struct alignas(cache_line_v) Event {
+		std::atomic<std::uint32_t> epoch{};
+		// registrations since the last wake: taken by the waker, so items pushed while a woken waiter is yet to run don't notify again
+		std::atomic<std::uint32_t> waiters{};
+
+		void signal() {
+			++epoch;
+			if (waiters.load() > 0 && waiters.exchange(0) > 0) { epoch.notify_all(); }
+		}
+
+		template <typename Pred>
+		void wait_until(Pred pred) {
+			for (;;) {
+				// snapshot before registering: a signal after the snapshot either sees the registration or changes the epoch waited on
+				auto const current = epoch.load();
+				++waiters;
+				if (pred()) { return; }
+				epoch.wait(current);
+			}
+		}
+	};
+
+	std::vector<Cell> m_cells;
+	std::size_t m_mask;
+	// producers and consumers contend on separate cache lines
+	alignas(cache_line_v) std::atomic<std::size_t> m_push{};
+	alignas(cache_line_v) std::atomic<std::size_t> m_pop{};
+	// consumers wait on pushes, producers wait on pops
+	Event m_pushed{};
+	Event m_popped{};
+};
+} // namespace facade
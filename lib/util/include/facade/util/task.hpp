@@ -0,0 +1,320 @@
+#pragma once
+#include <facade/util/thread_pool.hpp>
+#include <condition_variable>
+#include <exception>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace facade {
+template <typename T>
+class Task;
+
+template <typename F, typename T>
+struct ContinuationResult {
+	using type = std::invoke_result_t<F&, T const&>;
+};
+
+template <typename F>
+struct ContinuationResult<F, void> {
+	using type = std::invoke_result_t<F&>;
+};
+
+template <typename F>
+auto spawn(ThreadPool* pool, F func, std::optional<ThreadPool::Priority> priority = {}) -> Task<std::invoke_result_t<F>>;
+
+template <typename T>
+Task<void> when_all(std::span<Task<T> const> tasks);
+
+template <typename T>
+Task<std::size_t> when_any(std::span<Task<T> const> tasks);
+
+///
+/// \brief Shared handle to the result of a task running on a ThreadPool.
+///
+/// Unlike std::future, a Task can be copied (all copies observe the same result)
+/// and composed without blocking: continuations added via then() are scheduled on the pool when the task completes.
+/// The result, exception, and continuations share a single allocation, no std::promise is involved.
+///
+template <typename T>
+class Task {
+  public:
+	using value_type = T;
+
+	Task() = default;
+
+	///
+	/// \brief Check if this instance refers to a task.
+	///
+	bool valid() const { return m_state != nullptr; }
+	///
+	/// \brief Check if the task has completed (non-blocking).
+	///
+	bool ready() const { return m_state && m_state->ready; }
+
+	///
+	/// \brief Wait for the task to complete.
+	///
+	/// Runs other queued tasks meanwhile if called from a worker thread of the pool (see ThreadPool::wait()).
+	///
+	void wait() const {
+		assert(valid());
+		if (m_state->pool) {
+			m_state->pool->wait(*m_state);
+		} else {
+			m_state->wait();
+		}
+	}
+
+	template <typename Rep, typename Period>
+	std::future_status wait_for(std::chrono::duration<Rep, Period> const& duration) const {
+		assert(valid());
+		return m_state->wait_for(duration);
+	}
+
+	///
+	/// \brief Wait for and obtain the result.
+	/// \returns Const reference to the result (if non void)
+	///
+	/// This function purposely rethrows any exception thrown by the task.
+	///
+	decltype(auto) get() const noexcept(false) {
+		wait();
+		if (m_state->error) { std::rethrow_exception(m_state->error); }
+		if constexpr (!std::is_void_v<T>) { return static_cast<T const&>(*m_state->value); }
+	}
+
+	///
+	/// \brief Wait for and move the result out.
+	/// \returns The result (if non void)
+	///
+	/// Only the sole consumer of the task should take its result.
+	/// This function purposely rethrows any exception thrown by the task.
+	///
+	T take() noexcept(false) {
+		wait();
+		if (m_state->error) { std::rethrow_exception(m_state->error); }
+		if constexpr (!std::is_void_v<T>) { return std::move(*m_state->value); }
+	}
+
+	///
+	/// \brief Schedule a continuation to run on the pool once this task completes.
+	/// \param func Callable taking the result by const reference (or nothing, if void)
+	/// \returns Task of the continuation's result
+	///
+	/// If this task throws, func is not invoked and the exception is propagated to the returned task.
+	///
+	template <typename F>
+	auto then(F func) const {
+		assert(valid());
+		using Ret = typename ContinuationResult<F, T>::type;
+		auto ret = Task<Ret>{m_state->pool};
+		auto run = [prev = m_state, next = typename Task<Ret>::Pending{ret.m_state}, f = std::move(func)]() mutable {
+			next.take()->run([&] {
+				if (prev->error) { std::rethrow_exception(prev->error); }
+				if constexpr (std::is_void_v<T>) {
+					return f();
+				} else {
+					return f(static_cast<T const&>(*prev->value));
+				}
+			});
+		};
+		m_state->on_ready([pool = m_state->pool, r = std::move(run)]() mutable {
+			if (pool) {
+				pool->post(std::move(r));
+			} else {
+				r();
+			}
+		});
+		return ret;
+	}
+
+  private:
+	using Value = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+	struct State {
+		ThreadPool* pool{};
+		std::optional<Value> value{};
+		std::exception_ptr error{};
+		std::vector<UniqueTask<void()>> continuations{};
+		mutable std::mutex mutex{};
+		mutable std::condition_variable cv{};
+		std::atomic<bool> ready{};
+
+		template <typename F>
+		void run(F&& func) {
+			try {
+				if constexpr (std::is_void_v<T>) {
+					func();
+					value.emplace();
+				} else {
+					value.emplace(func());
+				}
+			} catch (...) { error = std::current_exception(); }
+			complete();
+		}
+
+		// completes as a std::future does when its promise is destroyed
+		void cancel() {
+			error = std::make_exception_ptr(std::future_error{std::future_errc::broken_promise});
+			complete();
+		}
+
+		void complete() {
+			auto lock = std::unique_lock{mutex};
+			ready = true;
+			auto ready_continuations = std::move(continuations);
+			lock.unlock();
+			cv.notify_all();
+			for (auto& continuation : ready_continuations) { continuation(); }
+		}
+
+		// invoked on the completing thread, or immediately if already complete: must be cheap
+		void on_ready(UniqueTask<void()> continuation) {
+			auto lock = std::unique_lock{mutex};
+			if (!ready) {
+				continuations.push_back(std::move(continuation));
+				return;
+			}
+			lock.unlock();
+			continuation();
+		}
+
+		// ThreadPool::wait() interface
+		bool valid() const { return true; }
+
+		void wait() const {
+			if (ready) { return; }
+			auto lock = std::unique_lock{mutex};
+			cv.wait(lock, [this] { return ready.load(); });
+		}
+
+		template <typename Rep, typename Period>
+		std::future_status wait_for(std::chrono::duration<Rep, Period> const& duration) const {
+			if (ready) { return std::future_status::ready; }
+			auto lock = std::unique_lock{mutex};
+			return cv.wait_for(lock, duration, [this] { return ready.load(); }) ? std::future_status::ready : std::future_status::timeout;
+		}
+	};
+
+	// owned by the pool task that runs a state: cancels it if that task is dropped without running (pool destroyed first)
+	class Pending {
+	  public:
+		explicit Pending(std::shared_ptr<State> state) : m_state(std::move(state)) {}
+		Pending(Pending&&) = default;
+		Pending& operator=(Pending&&) = delete;
+		~Pending() {
+			if (m_state) { m_state->cancel(); }
+		}
+
+		std::shared_ptr<State> take() { return std::move(m_state); }
+
+	  private:
+		std::shared_ptr<State> m_state{};
+	};
+
+	explicit Task(ThreadPool* pool) : m_state(std::make_shared<State>()) { m_state->pool = pool; }
+
+	std::shared_ptr<State> m_state{};
+
+	template <typename U>
+	friend class Task;
+	template <typename F>
+	friend auto spawn(ThreadPool* pool, F func, std::optional<ThreadPool::Priority> priority) -> Task<std::invoke_result_t<F>>;
+	template <typename U>
+	friend Task<void> when_all(std::span<Task<U> const> tasks);
+	template <typename U>
+	friend Task<std::size_t> when_any(std::span<Task<U> const> tasks);
+};
+
+///
+/// \brief Run a callable as a Task on a thread pool.
+/// \param pool Pool to run on (runs on the calling thread if null)
+/// \param func Callable to run
+/// \param priority Priority of the task (inherited if unset)
+/// \returns Task of the callable's result
+///
+template <typename F>
+auto spawn(ThreadPool* pool, F func, std::optional<ThreadPool::Priority> priority) -> Task<std::invoke_result_t<F>> {
+	auto ret = Task<std::invoke_result_t<F>>{pool};
+	if (!pool) {
+		ret.m_state->run(func);
+		return ret;
+	}
+	using Pending = typename Task<std::invoke_result_t<F>>::Pending;
+	pool->post([pending = Pending{ret.m_state}, f = std::move(func)]() mutable { pending.take()->run(f); }, priority);
+	return ret;
+}
+
+///
+/// \brief Obtain a Task that completes once all tasks have completed.
+/// \param tasks Tasks to wait for (all must be valid)
+/// \returns Task that completes with the first exception thrown by tasks, if any
+///
+/// Completion is signalled on the thread that completes the last task, no thread blocks waiting.
+///
+template <typename T>
+Task<void> when_all(std::span<Task<T> const> tasks) {
+	auto ret = Task<void>{tasks.empty() ? nullptr : tasks.front().m_state->pool};
+	if (tasks.empty()) {
+		ret.m_state->run([] {});
+		return ret;
+	}
+	struct Join {
+		std::atomic<std::size_t> remaining{};
+		std::exception_ptr error{};
+		std::mutex mutex{};
+	};
+	auto join = std::make_shared<Join>();
+	join->remaining = tasks.size();
+	for (auto const& task : tasks) {
+		// the source state is alive while its continuations run
+		task.m_state->on_ready([join, state = ret.m_state, source = task.m_state.get()] {
+			if (source->error) {
+				auto lock = std::scoped_lock{join->mutex};
+				if (!join->error) { join->error = source->error; }
+			}
+			if (--join->remaining > 0) { return; }
+			state->run([&join] {
+				if (join->error) { std::rethrow_exception(join->error); }
+			});
+		});
+	}
+	return ret;
+}
+
+///
+/// \brief Obtain a Task that completes once any task has completed.
+/// \param tasks Tasks to wait for (all must be valid, and at least one)
+/// \returns Task of the index of the first task to complete
+///
+template <typename T>
+Task<std::size_t> when_any(std::span<Task<T> const> tasks) {
+	assert(!tasks.empty());
+	auto ret = Task<std::size_t>{tasks.front().m_state->pool};
+	auto claimed = std::make_shared<std::atomic<bool>>();
+	for (std::size_t index = 0; index < tasks.size(); ++index) {
+		tasks[index].m_state->on_ready([claimed, state = ret.m_state, index] {
+			if (claimed->exchange(true)) { return; }
+			state->run([index] { return index; });
+		});
+	}
+	return ret;
+}
+
+///
+/// \brief Obtain a Task that completes once all tasks have completed (deduces T, see span overload).
+///
+template <typename T>
+Task<void> when_all(std::vector<Task<T>> const& tasks) {
+	return when_all(std::span<Task<T> const>{tasks});
+}
+
+///
+/// \brief Obtain a Task that completes once any task has completed (deduces T, see span overload).
+///
+template <typename T>
+Task<std::size_t> when_any(std::vector<Task<T>> const& tasks) {
+	return when_any(std::span<Task<T> const>{tasks});
+}
+} // namespace facade
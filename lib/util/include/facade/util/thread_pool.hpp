@@ -1,38 +1,142 @@
 #pragma once
-#include <facade/util/async_queue.hpp>
+#include <facade/util/ring_queue.hpp>
 #include <facade/util/unique_task.hpp>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <deque>
 #include <future>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
 #include <thread>
 #include <vector>
 
 namespace facade {
+struct ThreadPoolCreateInfo {
+	///
+	/// \brief Number of threads to create (clamped to hardware concurrency).
+	///
+	std::optional<std::uint32_t> thread_count{};
+	///
+	/// \brief Worker thread name prefix, suffixed with the worker index (unnamed if empty).
+	///
+	/// Names are truncated to 15 characters on Linux.
+	///
+	std::string name{};
+	///
+	/// \brief CPUs to pin workers to: worker i runs on affinity[i % size] (unpinned if empty).
+	///
+	/// Ignored on platforms without thread affinity support.
+	///
+	std::vector<std::uint32_t> affinity{};
+};
+
 ///
-/// \brief Pool of fixed number of threads and a single shared task queue.
+/// \brief Pool of fixed number of threads, each with its own task deques.
+///
+/// Tasks have a priority: queued higher priority tasks always run first, anywhere in the pool.
+/// Tasks enqueued without a priority inherit that of the task enqueueing them (else Priority::eNormal).
+///
+/// Workers run their own tasks newest first and steal the oldest tasks of other workers when idle.
+/// Tasks enqueued from a worker are pushed to its own deque, tasks from other threads go into a lock-free injection queue
+/// (or round-robin into worker deques when that is full).
+/// Waiting on a future via wait() from a worker runs other queued tasks meanwhile:
+/// tasks can enqueue nested tasks and wait for them, even on a single worker.
+/// Tasks still queued when the pool is destroyed are dropped without running:
+/// their futures (and Tasks, see spawn()) complete with std::future_error (broken_promise).
 ///
 class ThreadPool {
   public:
+	using CreateInfo = ThreadPoolCreateInfo;
+
+	///
+	/// \brief Priority class of a task.
+	///
+	enum class Priority : std::uint8_t {
+		///
+		/// \brief Latency sensitive (per-frame) work.
+		///
+		eHigh,
+		eNormal,
+		///
+		/// \brief Bulk / background work (asset loading).
+		///
+		eLow,
+		eCOUNT_,
+	};
+
+	///
+	/// \brief Construct a ThreadPool.
+	/// \param thread_count Number of threads to create
+	///
+	ThreadPool(std::optional<std::uint32_t> thread_count = {}) : ThreadPool(CreateInfo{.thread_count = thread_count}) {}
 	///
 	/// \brief Construct a ThreadPool.
-	/// \param threads Number of threads to create
+	/// \param create_info Thread count, names, and affinity
 	///
-	ThreadPool(std::optional<std::uint32_t> thread_count = {});
+	explicit ThreadPool(CreateInfo const& create_info);
 	~ThreadPool();
 
+	ThreadPool& operator=(ThreadPool&&) = delete;
+
 	///
 	/// \brief Schedule a task to be run on the thread pool.
 	/// \param func The task to enqueue.
+	/// \param priority Priority of the task (inherited if unset)
 	/// \returns Future of task invocation result
 	///
 	template <typename F>
-	auto enqueue(F func) -> std::future<std::invoke_result_t<F>> {
+	auto enqueue(F func, std::optional<Priority> priority = {}) -> std::future<std::invoke_result_t<F>> {
 		using Ret = std::invoke_result_t<F>;
 		auto promise = std::promise<Ret>{};
 		auto ret = promise.get_future();
-		push(std::move(promise), std::move(func));
+		push(std::move(promise), std::move(func), priority);
 		return ret;
 	}
 
+	///
+	/// \brief Schedule a task to be run on the thread pool, without a future.
+	/// \param job The task to enqueue (must not throw)
+	/// \param priority Priority of the task (inherited if unset)
+	///
+	void post(UniqueTask<void()> job, std::optional<Priority> priority = {});
+
+	///
+	/// \brief Wait for a future to become ready.
+	/// \param future Future to wait on (must be valid)
+	///
+	/// If called from a worker thread of this pool, queued tasks are run until the future is ready (see help()).
+	///
+	template <typename Future>
+	void wait(Future const& future) {
+		assert(future.valid());
+		if (!is_worker()) {
+			future.wait();
+			return;
+		}
+		while (future.wait_for(std::chrono::seconds{}) != std::future_status::ready) {
+			// the future depends on tasks running on other workers: block briefly, they may enqueue more work
+			if (!help()) { future.wait_for(help_interval_v); }
+		}
+	}
+
+	///
+	/// \brief Run one queued task, if called from a worker thread of this pool.
+	/// \returns true If a task was run
+	///
+	/// Only tasks of the same or higher priority as the calling task are run while another worker is idle (it picks up the rest).
+	/// Lower priority tasks are run once no worker is idle: the calling task may be waiting on one of them.
+	///
+	bool help();
+
+	///
+	/// \brief Check if the calling thread is a worker thread of this pool.
+	///
+	bool is_worker() const;
+
 	///
 	/// \brief Obtain the number of worker threads active on the task queue.
 	/// \returns The number of worker threads active on the task queue
@@ -40,9 +144,17 @@ class ThreadPool {
 	std::size_t thread_count() const { return m_threads.size(); }
 
   private:
+	static constexpr auto help_interval_v = std::chrono::microseconds{100};
+	static constexpr std::size_t priorities_v{static_cast<std::size_t>(Priority::eCOUNT_)};
+
+	struct Worker {
+		std::array<std::deque<UniqueTask<void()>>, priorities_v> tasks{};
+		std::mutex mutex{};
+	};
+
 	template <typename T, typename F>
-	void push(std::promise<T>&& promise, F func) {
-		m_queue.push([p = std::move(promise), f = std::move(func)]() mutable {
+	void push(std::promise<T>&& promise, F func, std::optional<Priority> priority) {
+		post([p = std::move(promise), f = std::move(func)]() mutable {
 			try {
 				if constexpr (std::is_void_v<T>) {
 					f();
@@ -55,10 +167,21 @@ class ThreadPool {
 					p.set_exception(std::current_exception());
 				} catch (...) {}
 			}
-		});
+		}, priority);
 	}
 
-	AsyncQueue<UniqueTask<void()>> m_queue{};
+	std::optional<UniqueTask<void()>> pop(std::size_t worker, Priority& out_priority, Priority lowest = Priority::eLow);
+	void execute(UniqueTask<void()> const& job, Priority priority) const;
+	void run(std::size_t worker, CreateInfo const& create_info, std::stop_token const& stop);
+
+	std::vector<std::unique_ptr<Worker>> m_workers{};
+	// injection queues for tasks posted from other threads, per priority
+	std::array<RingQueue<UniqueTask<void()>>, priorities_v> m_injected;
+	// number of queued tasks: idle workers wait on this
+	std::atomic<std::uint32_t> m_queued{};
+	// number of workers waiting on m_queued
+	std::atomic<std::uint32_t> m_idle{};
+	std::atomic<std::size_t> m_next{};
 	std::vector<std::jthread> m_threads{};
 };
 
@@ -66,12 +189,13 @@ template <typename T>
 struct MaybeFuture {
 	std::future<T> future{};
 	std::optional<T> t{};
+	ThreadPool* pool{};
 
 	MaybeFuture() = default;
 
 	template <typename F>
 		requires(std::same_as<std::invoke_result_t<F>, T>)
-	MaybeFuture(ThreadPool& pool, F func) : future(pool.enqueue([f = std::move(func)] { return f(); })) {}
+	MaybeFuture(ThreadPool& pool, F func) : future(pool.enqueue([f = std::move(func)]() mutable { return f(); })), pool(&pool) {}
 
 	template <typename F>
 		requires(std::same_as<std::invoke_result_t<F>, T>)
@@ -81,7 +205,10 @@ struct MaybeFuture {
 
 	T get() {
 		assert(active());
-		if (future.valid()) { return future.get(); }
+		if (future.valid()) {
+			if (pool) { pool->wait(future); }
+			return future.get();
+		}
 		return std::move(*t);
 	}
 };
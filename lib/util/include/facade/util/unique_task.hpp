@@ -1,6 +1,10 @@
 #pragma once
 #include <cassert>
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace facade {
 template <typename T>
@@ -9,9 +13,22 @@ class UniqueTask;
 ///
 /// \brief Type erased move-only callable (discount std::move_only_function).
 ///
+/// Callables up to inline_size_v bytes (that are nothrow movable) are stored inline, larger ones on the heap.
+///
 template <typename Ret, typename... Args>
 class UniqueTask<Ret(Args...)> {
   public:
+	///
+	/// \brief Size of inline storage: the whole instance occupies a cache line.
+	///
+	static constexpr std::size_t inline_size_v{64 - sizeof(void*)};
+
+	///
+	/// \brief Check if a callable type is stored inline.
+	///
+	template <typename T>
+	static constexpr bool is_inline_v = sizeof(T) <= inline_size_v && alignof(T) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<T>;
+
 	UniqueTask() = default;
 
 	///
@@ -20,7 +37,28 @@ class UniqueTask<Ret(Args...)> {
 	///
 	template <typename T>
 		requires(!std::same_as<UniqueTask, T> && std::is_invocable_r_v<Ret, T, Args...>)
-	UniqueTask(T t) : m_func(std::make_unique<Func<T>>(std::move(t))) {}
+	UniqueTask(T t) : m_vtable(&vtable_v<T>) {
+		if constexpr (is_inline_v<T>) {
+			new (m_storage) T(std::move(t));
+		} else {
+			new (m_storage) T*(new T(std::move(t)));
+		}
+	}
+
+	UniqueTask(UniqueTask&& rhs) noexcept : m_vtable(std::exchange(rhs.m_vtable, nullptr)) {
+		if (m_vtable) { m_vtable->move(m_storage, rhs.m_storage); }
+	}
+
+	UniqueTask& operator=(UniqueTask&& rhs) noexcept {
+		if (&rhs != this) {
+			reset();
+			m_vtable = std::exchange(rhs.m_vtable, nullptr);
+			if (m_vtable) { m_vtable->move(m_storage, rhs.m_storage); }
+		}
+		return *this;
+	}
+
+	~UniqueTask() { reset(); }
 
 	///
 	/// \brief Invoke stored callable and obtain the result (if non void).
@@ -28,28 +66,62 @@ class UniqueTask<Ret(Args...)> {
 	/// \returns Return value of callable (if any)
 	///
 	Ret operator()(Args... args) const {
-		assert(m_func);
-		return (*m_func)(args...);
+		assert(m_vtable);
+		return m_vtable->invoke(m_storage, std::forward<Args>(args)...);
 	}
 
 	///
 	/// \brief Check if a callable is stored.
 	/// \returns true If a callable is stored.
 	///
-	explicit operator bool() const { return m_func != nullptr; }
+	explicit operator bool() const { return m_vtable != nullptr; }
 
   private:
-	struct Base {
-		virtual ~Base() = default;
-		virtual void operator()(Args...) = 0;
+	struct VTable {
+		Ret (*invoke)(void* storage, Args&&... args);
+		// move constructs into dst and destroys src
+		void (*move)(void* dst, void* src) noexcept;
+		void (*destroy)(void* storage) noexcept;
 	};
-	template <typename F>
-	struct Func : Base {
-		F f;
-		Func(F&& f) : f(std::move(f)) {}
-		void operator()(Args... args) final { f(args...); }
+
+	template <typename T>
+	static T& get(void* storage) {
+		if constexpr (is_inline_v<T>) {
+			return *std::launder(static_cast<T*>(storage));
+		} else {
+			return **std::launder(static_cast<T**>(storage));
+		}
+	}
+
+	template <typename T>
+	static constexpr VTable vtable_v{
+		.invoke = [](void* storage, Args&&... args) -> Ret { return static_cast<Ret>(get<T>(storage)(std::forward<Args>(args)...)); },
+		.move =
+			[](void* dst, void* src) noexcept {
+				if constexpr (is_inline_v<T>) {
+					new (dst) T(std::move(get<T>(src)));
+					get<T>(src).~T();
+				} else {
+					// only the pointer moves
+					new (dst) T*(*std::launder(static_cast<T**>(src)));
+				}
+			},
+		.destroy =
+			[](void* storage) noexcept {
+				if constexpr (is_inline_v<T>) {
+					get<T>(storage).~T();
+				} else {
+					delete &get<T>(storage);
+				}
+			},
 	};
 
-	std::unique_ptr<Base> m_func{};
+	void reset() {
+		if (m_vtable) { m_vtable->destroy(m_storage); }
+		m_vtable = {};
+	}
+
+	alignas(std::max_align_t) mutable std::byte m_storage[inline_size_v]{};
+	VTable const* m_vtable{};
 };
 } // namespace facade
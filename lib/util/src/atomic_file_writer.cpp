@@ -0,0 +1,47 @@
+#include <facade/util/atomic_file_writer.hpp>
+#include <facade/util/logger.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+namespace facade {
+namespace fs = std::filesystem;
+
+AtomicFileWriter::AtomicFileWriter(std::string path)
+	: m_path(std::move(path)), m_temp(fmt::format("{}.{}.tmp", m_path, std::hash<std::thread::id>{}(std::this_thread::get_id()))),
+	  m_file(m_temp, std::ios::binary | std::ios::trunc) {}
+
+AtomicFileWriter::~AtomicFileWriter() {
+	if (m_committed) { return; }
+	m_file.close();
+	auto error = std::error_code{};
+	fs::remove(m_temp, error);
+}
+
+void AtomicFileWriter::write(std::span<std::byte const> bytes) {
+	m_file.write(reinterpret_cast<char const*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	m_written += bytes.size();
+}
+
+void AtomicFileWriter::pad_to(std::uint64_t offset) {
+	static constexpr std::byte zeros_v[256]{};
+	while (m_written < offset) { write(std::span{zeros_v}.first(static_cast<std::size_t>(std::min<std::uint64_t>(offset - m_written, sizeof(zeros_v))))); }
+}
+
+bool AtomicFileWriter::commit() {
+	m_file.close();
+	if (!m_file) {
+		logger::warn("[AtomicFileWriter] Failed to write: [{}]", m_temp);
+		return false;
+	}
+	auto error = std::error_code{};
+	fs::rename(m_temp, m_path, error);
+	if (error) {
+		logger::warn("[AtomicFileWriter] Failed to replace: [{}]", m_path);
+		return false;
+	}
+	m_committed = true;
+	return true;
+}
+} // namespace facade
@@ -0,0 +1,459 @@
+#include <facade/util/atomic_file_writer.hpp>
+#include <facade/util/block_compressor.hpp>
+#include <facade/util/data_provider.hpp>
+#include <facade/util/enumerate.hpp>
+#include <facade/util/logger.hpp>
+#include <facade/util/parallel.hpp>
+#include <fmt/format.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+namespace facade {
+namespace fs = std::filesystem;
+
+namespace {
+// bump when encoder output changes, to invalidate cached images
+constexpr std::uint32_t encoder_version_v{1};
+
+constexpr std::uint32_t vk_format_rgba8_unorm_v{37};
+constexpr std::uint32_t vk_format_bc5_unorm_v{141};
+constexpr std::uint32_t vk_format_bc7_unorm_v{145};
+// both BC5 and BC7 encode 4x4 texels into 16 bytes
+constexpr std::size_t block_bytes_v{16};
+
+using Block = std::array<std::uint8_t, block_bytes_v>;
+using Texel = std::array<float, 4>;
+
+struct Level {
+	std::vector<std::byte> bytes{};
+	glm::uvec2 extent{};
+};
+
+struct Rgba8 {
+	std::span<std::byte const> bytes{};
+	glm::uvec2 extent{};
+
+	std::uint8_t at(std::uint32_t x, std::uint32_t y, std::size_t channel) const {
+		return static_cast<std::uint8_t>(bytes[(static_cast<std::size_t>(y) * extent.x + x) * 4 + channel]);
+	}
+
+	// out of range texels are clamped to the edge
+	std::array<Texel, 16> block(std::uint32_t bx, std::uint32_t by) const {
+		auto ret = std::array<Texel, 16>{};
+		for (std::uint32_t i = 0; i < 16; ++i) {
+			auto const x = std::min(bx * 4 + i % 4, extent.x - 1);
+			auto const y = std::min(by * 4 + i / 4, extent.y - 1);
+			for (std::size_t c = 0; c < 4; ++c) { ret[i][c] = at(x, y, c); }
+		}
+		return ret;
+	}
+};
+
+std::vector<std::byte> downsample(Rgba8 const image) {
+	auto const extent = glm::uvec2{std::max(image.extent.x / 2, 1u), std::max(image.extent.y / 2, 1u)};
+	auto ret = std::vector<std::byte>(static_cast<std::size_t>(extent.x) * extent.y * 4);
+	for (std::uint32_t y = 0; y < extent.y; ++y) {
+		for (std::uint32_t x = 0; x < extent.x; ++x) {
+			auto const x0 = std::min(x * 2, image.extent.x - 1), x1 = std::min(x * 2 + 1, image.extent.x - 1);
+			auto const y0 = std::min(y * 2, image.extent.y - 1), y1 = std::min(y * 2 + 1, image.extent.y - 1);
+			for (std::size_t c = 0; c < 4; ++c) {
+				auto const sum = image.at(x0, y0, c) + image.at(x1, y0, c) + image.at(x0, y1, c) + image.at(x1, y1, c);
+				ret[(static_cast<std::size_t>(y) * extent.x + x) * 4 + c] = static_cast<std::byte>((sum + 2) / 4);
+			}
+		}
+	}
+	return ret;
+}
+
+struct BitWriter {
+	Block& out;
+	std::uint32_t offset{};
+
+	void operator()(std::uint32_t value, std::uint32_t bits) {
+		for (std::uint32_t i = 0; i < bits; ++i, ++offset) {
+			if ((value >> i) & 1u) { out[offset / 8] |= static_cast<std::uint8_t>(1u << (offset % 8)); }
+		}
+	}
+};
+
+// BC7 mode 6: single subset, RGBA 7.7.7.7 endpoints with unique P-bits, 4-bit indices
+struct Bc7Mode6 {
+	static constexpr std::array<std::uint32_t, 16> weights_v{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+	struct Endpoint {
+		std::array<std::uint32_t, 4> rgba{};
+		std::uint32_t p{};
+
+		std::uint32_t unpacked(std::size_t c) const { return (rgba[c] << 1) | p; }
+	};
+
+	struct Candidate {
+		std::array<Endpoint, 2> endpoints{};
+		std::array<std::uint32_t, 16> indices{};
+		float error{};
+	};
+
+	static Texel principal_axis(std::array<Texel, 16> const& texels, Texel const& mean) {
+		float cov[4][4]{};
+		for (auto const& t : texels) {
+			for (std::size_t i = 0; i < 4; ++i) {
+				for (std::size_t j = 0; j < 4; ++j) { cov[i][j] += (t[i] - mean[i]) * (t[j] - mean[j]); }
+			}
+		}
+		auto ret = Texel{1.0f, 1.0f, 1.0f, 1.0f};
+		for (int iteration = 0; iteration < 8; ++iteration) {
+			auto next = Texel{};
+			for (std::size_t i = 0; i < 4; ++i) {
+				for (std::size_t j = 0; j < 4; ++j) { next[i] += cov[i][j] * ret[j]; }
+			}
+			auto const length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+			// uniform block
+			if (length <= 0.0f) { return {}; }
+			for (std::size_t i = 0; i < 4; ++i) { ret[i] = next[i] / length; }
+		}
+		return ret;
+	}
+
+	static Endpoint quantize(Texel const& texel, std::uint32_t p) {
+		auto ret = Endpoint{.p = p};
+		for (std::size_t c = 0; c < 4; ++c) {
+			auto const value = std::lround((texel[c] - static_cast<float>(p)) * 0.5f);
+			ret.rgba[c] = static_cast<std::uint32_t>(std::clamp(value, 0L, 127L));
+		}
+		return ret;
+	}
+
+	static Candidate fit(std::array<Texel, 16> const& texels, std::array<Endpoint, 2> const& endpoints) {
+		auto palette = std::array<Texel, 16>{};
+		for (std::size_t i = 0; i < 16; ++i) {
+			for (std::size_t c = 0; c < 4; ++c) {
+				auto const value = ((64 - weights_v[i]) * endpoints[0].unpacked(c) + weights_v[i] * endpoints[1].unpacked(c) + 32) >> 6;
+				palette[i][c] = static_cast<float>(value);
+			}
+		}
+		auto const distance = [](Texel const& a, Texel const& b) {
+			auto ret = 0.0f;
+			for (std::size_t c = 0; c < 4; ++c) { ret += (a[c] - b[c]) * (a[c] - b[c]); }
+			return ret;
+		};
+		auto axis = Texel{};
+		auto axis_length2 = 0.0f;
+		for (std::size_t c = 0; c < 4; ++c) {
+			axis[c] = palette[15][c] - palette[0][c];
+			axis_length2 += axis[c] * axis[c];
+		}
+		auto ret = Candidate{.endpoints = endpoints};
+		for (std::size_t i = 0; i < 16; ++i) {
+			// project onto the endpoint line, then refine against the (non-uniform) neighbouring weights
+			auto t = 0.0f;
+			if (axis_length2 > 0.0f) {
+				for (std::size_t c = 0; c < 4; ++c) { t += (texels[i][c] - palette[0][c]) * axis[c]; }
+				t /= axis_length2;
+			}
+			auto const guess = static_cast<int>(std::clamp(std::lround(t * 15.0f), 0L, 15L));
+			auto best = std::uint32_t{};
+			auto best_error = std::numeric_limits<float>::max();
+			for (int index = std::max(guess - 1, 0); index <= std::min(guess + 1, 15); ++index) {
+				if (auto const error = distance(texels[i], palette[static_cast<std::size_t>(index)]); error < best_error) {
+					best_error = error;
+					best = static_cast<std::uint32_t>(index);
+				}
+			}
+			ret.indices[i] = best;
+			ret.error += best_error;
+		}
+		return ret;
+	}
+
+	static Block encode(std::array<Texel, 16> const& texels) {
+		auto mean = Texel{};
+		for (auto const& t : texels) {
+			for (std::size_t c = 0; c < 4; ++c) { mean[c] += t[c] / 16.0f; }
+		}
+		auto const axis = principal_axis(texels, mean);
+		auto t_min = 0.0f, t_max = 0.0f;
+		for (auto const& t : texels) {
+			auto projection = 0.0f;
+			for (std::size_t c = 0; c < 4; ++c) { projection += (t[c] - mean[c]) * axis[c]; }
+			t_min = std::min(t_min, projection);
+			t_max = std::max(t_max, projection);
+		}
+		auto lo = Texel{}, hi = Texel{};
+		for (std::size_t c = 0; c < 4; ++c) {
+			lo[c] = std::clamp(mean[c] + axis[c] * t_min, 0.0f, 255.0f);
+			hi[c] = std::clamp(mean[c] + axis[c] * t_max, 0.0f, 255.0f);
+		}
+
+		auto best = Candidate{.error = std::numeric_limits<float>::max()};
+		for (std::uint32_t p0 = 0; p0 < 2; ++p0) {
+			for (std::uint32_t p1 = 0; p1 < 2; ++p1) {
+				if (auto candidate = fit(texels, {quantize(lo, p0), quantize(hi, p1)}); candidate.error < best.error) { best = candidate; }
+			}
+		}
+		// the MSB of the first index is implicitly 0
+		if (best.indices[0] >= 8) {
+			std::swap(best.endpoints[0], best.endpoints[1]);
+			for (auto& index : best.indices) { index = 15 - index; }
+		}
+
+		auto ret = Block{};
+		auto write = BitWriter{ret};
+		write(1u << 6, 7);
+		for (std::size_t c = 0; c < 4; ++c) {
+			write(best.endpoints[0].rgba[c], 7);
+			write(best.endpoints[1].rgba[c], 7);
+		}
+		write(best.endpoints[0].p, 1);
+		write(best.endpoints[1].p, 1);
+		write(best.indices[0], 3);
+		for (std::size_t i = 1; i < 16; ++i) { write(best.indices[i], 4); }
+		return ret;
+	}
+};
+
+// BC4 (single channel) block, written into 8 bytes of out
+void encode_bc4(std::array<Texel, 16> const& texels, std::size_t channel, std::uint8_t* out) {
+	auto lo = 255.0f, hi = 0.0f;
+	for (auto const& t : texels) {
+		lo = std::min(lo, t[channel]);
+		hi = std::max(hi, t[channel]);
+	}
+	auto const e0 = static_cast<std::uint32_t>(hi), e1 = static_cast<std::uint32_t>(lo);
+	out[0] = static_cast<std::uint8_t>(e0);
+	out[1] = static_cast<std::uint8_t>(e1);
+	if (e0 == e1) { return; }
+	// e0 > e1: 8 level palette, [e0, e1, 6 interpolants from e0 to e1]
+	auto palette = std::array<std::uint32_t, 8>{e0, e1};
+	for (std::uint32_t i = 2; i < 8; ++i) { palette[i] = ((8 - i) * e0 + (i - 1) * e1 + 3) / 7; }
+	auto bits = std::uint64_t{};
+	for (std::size_t i = 0; i < 16; ++i) {
+		auto const value = texels[i][channel];
+		auto const nearest = std::min_element(palette.begin(), palette.end(), [value](std::uint32_t a, std::uint32_t b) {
+			return std::abs(static_cast<float>(a) - value) < std::abs(static_cast<float>(b) - value);
+		});
+		bits |= static_cast<std::uint64_t>(nearest - palette.begin()) << (i * 3);
+	}
+	for (std::size_t i = 0; i < 6; ++i) { out[2 + i] = static_cast<std::uint8_t>(bits >> (i * 8)); }
+}
+
+Block encode_bc5(std::array<Texel, 16> const& texels) {
+	auto ret = Block{};
+	// G and B channels are stored in R and G
+	encode_bc4(texels, 1, ret.data());
+	encode_bc4(texels, 2, ret.data() + 8);
+	return ret;
+}
+
+constexpr std::uint32_t to_vk_format(BlockCompressor::Format const format) {
+	switch (format) {
+	case BlockCompressor::Format::eBc5: return vk_format_bc5_unorm_v;
+	case BlockCompressor::Format::eRgba8: return vk_format_rgba8_unorm_v;
+	default: return vk_format_bc7_unorm_v;
+	}
+}
+
+constexpr std::string_view to_str(BlockCompressor::Format const format) {
+	switch (format) {
+	case BlockCompressor::Format::eBc5: return "bc5";
+	case BlockCompressor::Format::eRgba8: return "rgba8";
+	default: return "bc7";
+	}
+}
+
+// block rows are encoded in parallel: each writes a disjoint span of the output
+std::vector<std::byte> encode_level(Rgba8 const image, BlockCompressor::Format format, ThreadPool* pool) {
+	if (format == BlockCompressor::Format::eRgba8) { return {image.bytes.begin(), image.bytes.end()}; }
+	auto const blocks = glm::uvec2{(image.extent.x + 3) / 4, (image.extent.y + 3) / 4};
+	auto const row_bytes = static_cast<std::size_t>(blocks.x) * block_bytes_v;
+	auto ret = std::vector<std::byte>(row_bytes * blocks.y);
+	auto encode_row = [&](std::size_t const by) {
+		auto* out = ret.data() + by * row_bytes;
+		for (std::uint32_t bx = 0; bx < blocks.x; ++bx, out += block_bytes_v) {
+			auto const texels = image.block(bx, static_cast<std::uint32_t>(by));
+			auto const block = format == BlockCompressor::Format::eBc5 ? encode_bc5(texels) : Bc7Mode6::encode(texels);
+			std::memcpy(out, block.data(), block.size());
+		}
+	};
+	parallel_for(pool, blocks.y, 0, encode_row);
+	return ret;
+}
+
+struct Ktx2Writer {
+	std::vector<std::byte> out{};
+
+	template <typename T>
+	void put(T const value) {
+		auto const* bytes = reinterpret_cast<std::byte const*>(&value);
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	template <typename T>
+	void patch(std::size_t offset, T const value) {
+		std::memcpy(out.data() + offset, &value, sizeof(T));
+	}
+
+	void align(std::size_t alignment) { out.resize((out.size() + alignment - 1) / alignment * alignment); }
+
+	// basic data format descriptor for uncompressed RGBA8
+	void put_rgba8_dfd() {
+		static constexpr std::uint32_t rgbsda_model_v{1};
+		static constexpr std::uint32_t channels_v[] = {0, 1, 2, 15};
+		static constexpr auto block_size_v = 24 + 16 * std::size(channels_v);
+		put<std::uint32_t>(4 + block_size_v);
+		put<std::uint32_t>(0);
+		put<std::uint32_t>(2u | (block_size_v << 16));
+		// model, primaries: BT709, transfer: linear, flags: straight alpha
+		put<std::uint32_t>(rgbsda_model_v | (1u << 8) | (1u << 16));
+		// texel block dimensions - 1 (single texel)
+		put<std::uint32_t>(0);
+		put<std::uint32_t>(4);
+		put<std::uint32_t>(0);
+		for (auto const [channel, sample] : enumerate(channels_v)) {
+			// bit offset, bit length - 1, channel (R, G, B, A)
+			put<std::uint32_t>(static_cast<std::uint32_t>(sample * 8) | (7u << 16) | (channel << 24));
+			put<std::uint32_t>(0);
+			put<std::uint32_t>(0);
+			put<std::uint32_t>(0xff);
+		}
+	}
+
+	// basic data format descriptor for a 4x4 block compressed format
+	void put_dfd(BlockCompressor::Format const format) {
+		if (format == BlockCompressor::Format::eRgba8) { return put_rgba8_dfd(); }
+		static constexpr std::uint32_t bc5_model_v{132}, bc7_model_v{134};
+		auto const samples = format == BlockCompressor::Format::eBc5 ? 2u : 1u;
+		auto const block_size = 24 + 16 * samples;
+		put<std::uint32_t>(4 + block_size);
+		put<std::uint32_t>(0);
+		put<std::uint32_t>(2u | (block_size << 16));
+		// model, primaries: BT709, transfer: linear, flags: straight alpha
+		put<std::uint32_t>((format == BlockCompressor::Format::eBc5 ? bc5_model_v : bc7_model_v) | (1u << 8) | (1u << 16));
+		// texel block dimensions - 1
+		put<std::uint32_t>(3u | (3u << 8));
+		put<std::uint32_t>(static_cast<std::uint32_t>(block_bytes_v));
+		put<std::uint32_t>(0);
+		for (std::uint32_t sample = 0; sample < samples; ++sample) {
+			// bit offset, bit length - 1, channel (BC7 colour / BC5 red, green)
+			put<std::uint32_t>((sample * 64) | ((samples == 1 ? 127u : 63u) << 16) | (sample << 24));
+			put<std::uint32_t>(0);
+			put<std::uint32_t>(0);
+			put<std::uint32_t>(0xffffffff);
+		}
+	}
+
+	void put_key_value(std::string_view key, std::string_view value) {
+		put<std::uint32_t>(static_cast<std::uint32_t>(key.size() + value.size() + 2));
+		for (auto const str : {key, value}) {
+			for (auto const ch : str) { put(ch); }
+			put('\0');
+		}
+		align(4);
+	}
+
+	ByteBuffer operator()(std::span<Level const> levels, BlockCompressor::Format const format) {
+		static constexpr std::uint8_t identifier_v[] = {0xab, 0x4b, 0x54, 0x58, 0x20, 0x32, 0x30, 0xbb, 0x0d, 0x0a, 0x1a, 0x0a};
+		static constexpr std::size_t level_index_offset_v{80};
+		for (auto const byte : identifier_v) { put(byte); }
+		put<std::uint32_t>(to_vk_format(format));
+		// type size, width, height, depth, layers, faces, levels, supercompression
+		for (auto const value : {1u, levels[0].extent.x, levels[0].extent.y, 0u, 0u, 1u, static_cast<std::uint32_t>(levels.size()), 0u}) { put(value); }
+		auto const index = out.size();
+		out.resize(level_index_offset_v + levels.size() * 3 * sizeof(std::uint64_t));
+
+		auto const dfd_offset = out.size();
+		put_dfd(format);
+		auto const kvd_offset = out.size();
+		if (format == BlockCompressor::Format::eBc5) { put_key_value("KTXswizzle", "0rg1"); }
+		auto const kvd_length = out.size() - kvd_offset;
+		patch(index, static_cast<std::uint32_t>(dfd_offset));
+		patch(index + 4, static_cast<std::uint32_t>(kvd_offset - dfd_offset));
+		patch(index + 8, static_cast<std::uint32_t>(kvd_length == 0 ? 0 : kvd_offset));
+		patch(index + 12, static_cast<std::uint32_t>(kvd_length));
+		// supercompression global data offset / length remain 0
+
+		// mip levels are stored smallest first
+		for (auto i = levels.size(); i-- > 0;) {
+			align(block_bytes_v);
+			auto const offset = level_index_offset_v + i * 3 * sizeof(std::uint64_t);
+			patch(offset, static_cast<std::uint64_t>(out.size()));
+			patch(offset + 8, static_cast<std::uint64_t>(levels[i].bytes.size()));
+			patch(offset + 16, static_cast<std::uint64_t>(levels[i].bytes.size()));
+			out.insert(out.end(), levels[i].bytes.begin(), levels[i].bytes.end());
+		}
+
+		auto ret = ByteBuffer::make(out.size());
+		std::memcpy(ret.data(), out.data(), out.size());
+		return ret;
+	}
+};
+} // namespace
+
+std::uint64_t BlockCompressor::hash(std::span<std::byte const> bytes) {
+	auto ret = std::uint64_t{0xcbf29ce484222325};
+	for (auto const byte : bytes) {
+		ret ^= static_cast<std::uint64_t>(byte);
+		ret *= 0x100000001b3;
+	}
+	return ret;
+}
+
+ByteBuffer BlockCompressor::encode(Image::View image, Format format, ThreadPool* pool) {
+	if (image.extent.x == 0 || image.extent.y == 0 || image.bytes.size() < static_cast<std::size_t>(image.extent.x) * image.extent.y * 4) { return {}; }
+	auto levels = std::vector<Level>{};
+	auto current = Rgba8{image.bytes, image.extent};
+	auto mip = std::vector<std::byte>{};
+	while (true) {
+		levels.push_back(Level{encode_level(current, format, pool), current.extent});
+		if (current.extent.x == 1 && current.extent.y == 1) { break; }
+		mip = downsample(current);
+		current = Rgba8{mip, {std::max(current.extent.x / 2, 1u), std::max(current.extent.y / 2, 1u)}};
+	}
+	return Ktx2Writer{}(levels, format);
+}
+
+BlockCompressor::BlockCompressor(std::string cache_directory, ThreadPool* pool) : m_cache_directory(std::move(cache_directory)), m_pool(pool) {
+	if (m_cache_directory.empty()) { return; }
+	auto error = std::error_code{};
+	fs::create_directories(m_cache_directory, error);
+	if (error) {
+		logger::warn("[BlockCompressor] Failed to create cache directory [{}], caching disabled", m_cache_directory);
+		m_cache_directory.clear();
+	}
+}
+
+CompressedImage BlockCompressor::operator()(std::span<std::byte const> source, Format format, std::string name) const {
+	auto const key = fmt::format("{:016x}_{}_v{}.ktx2", hash(source), to_str(format), encoder_version_v);
+	auto const cache_path = fs::path{m_cache_directory} / key;
+	if (!m_cache_directory.empty() && fs::is_regular_file(cache_path)) {
+		if (auto ret = CompressedImage{FileDataProvider{m_cache_directory}.load(key), name}) {
+			logger::debug("[BlockCompressor] Cache hit [{}]: [{}]", name, key);
+			return ret;
+		}
+		// corrupt (eg truncated) entry: re-encoded and replaced below
+		logger::warn("[BlockCompressor] Invalid cache entry [{}], re-encoding: [{}]", key, name);
+		auto error = std::error_code{};
+		fs::remove(cache_path, error);
+	}
+
+	auto const start = std::chrono::steady_clock::now();
+	auto const image = Image{source, name};
+	if (!image) { return {}; }
+	auto ktx2 = encode(image, format, m_pool);
+	if (!ktx2) { return {}; }
+	auto const elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start);
+	auto const extent = image.view().extent;
+	logger::debug("[BlockCompressor] Encoded [{}] ({}x{}) in [{:.1f}ms]", name, extent.x, extent.y, elapsed.count());
+	if (!m_cache_directory.empty()) {
+		auto file = AtomicFileWriter{cache_path.string()};
+		file.write(ktx2.span());
+		file.commit();
+	}
+	return CompressedImage{std::move(ktx2), std::move(name)};
+}
+} // namespace facade
@@ -11,6 +11,18 @@ namespace fs = std::filesystem;
 fs::path absolute_path(std::string_view const directory, std::string_view const uri) { return fs::absolute(fs::path{directory} / uri); }
 } // namespace
 
+DataView::DataView(ByteBuffer buffer) {
+	auto storage = std::make_shared<ByteBuffer const>(std::move(buffer));
+	m_bytes = storage->span();
+	m_storage = std::move(storage);
+}
+
+DataView::DataView(MappedFile file) {
+	auto storage = std::make_shared<MappedFile const>(std::move(file));
+	m_bytes = storage->bytes();
+	m_storage = std::move(storage);
+}
+
 FileDataProvider::FileDataProvider(std::string_view directory) {
 	auto const path = fs::absolute(directory);
 	if (!fs::is_directory(path)) {
@@ -34,4 +46,9 @@ ByteBuffer FileDataProvider::load(std::string_view uri) const {
 	logger::warn("Failed to open file: [{}]", path.generic_string());
 	return {};
 }
+
+DataView FileDataProvider::view(std::string_view uri) const {
+	auto const path = absolute_path(m_directory, uri).generic_string();
+	return DataView{MappedFile{path.c_str(), MappedFile::Access::eSequential}};
+}
 } // namespace facade
@@ -1,8 +1,132 @@
 #include <stb/stb_image.h>
 #include <facade/util/image.hpp>
+#include <facade/util/logger.hpp>
+#include <algorithm>
+#include <bit>
 #include <cstring>
+#include <optional>
+#include <string_view>
 
 namespace facade {
+namespace {
+constexpr std::uint8_t ktx2_identifier_v[] = {0xab, 0x4b, 0x54, 0x58, 0x20, 0x32, 0x30, 0xbb, 0x0d, 0x0a, 0x1a, 0x0a};
+
+struct Ktx2Header {
+	std::uint32_t vk_format{};
+	std::uint32_t type_size{};
+	std::uint32_t pixel_width{};
+	std::uint32_t pixel_height{};
+	std::uint32_t pixel_depth{};
+	std::uint32_t layer_count{};
+	std::uint32_t face_count{};
+	std::uint32_t level_count{};
+	std::uint32_t supercompression_scheme{};
+	std::uint32_t dfd_byte_offset{};
+	std::uint32_t dfd_byte_length{};
+	std::uint32_t kvd_byte_offset{};
+	std::uint32_t kvd_byte_length{};
+	// followed by supercompression global data offset and length (u64 each), unused
+};
+
+struct Ktx2Level {
+	std::uint64_t byte_offset{};
+	std::uint64_t byte_length{};
+	std::uint64_t uncompressed_byte_length{};
+};
+
+constexpr std::size_t ktx2_header_size_v{sizeof(ktx2_identifier_v) + 13 * sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t)};
+static_assert(sizeof(Ktx2Header) == 13 * sizeof(std::uint32_t));
+static_assert(sizeof(Ktx2Level) == 3 * sizeof(std::uint64_t));
+
+// KTX2 is little endian, as are all supported targets
+ByteBuffer copy(std::span<std::byte const> bytes) {
+	auto ret = ByteBuffer::make(bytes.size());
+	std::memcpy(ret.data(), bytes.data(), bytes.size());
+	return ret;
+}
+
+template <typename T>
+bool read(T& out, std::span<std::byte const> bytes, std::size_t offset) {
+	if (offset + sizeof(T) > bytes.size()) { return false; }
+	std::memcpy(&out, bytes.data() + offset, sizeof(T));
+	return true;
+}
+
+std::optional<std::array<char, 4>> find_swizzle(std::span<std::byte const> bytes, Ktx2Header const& header) {
+	static constexpr std::string_view key_v{"KTXswizzle"};
+	if (header.kvd_byte_offset > bytes.size() || header.kvd_byte_length > bytes.size() - header.kvd_byte_offset) { return {}; }
+	auto kvd = bytes.subspan(header.kvd_byte_offset, header.kvd_byte_length);
+	auto length = std::uint32_t{};
+	while (read(length, kvd, 0) && sizeof(length) + length <= kvd.size()) {
+		auto const entry = std::string_view{reinterpret_cast<char const*>(kvd.data()) + sizeof(length), length};
+		if (entry.starts_with(key_v) && entry.size() >= key_v.size() + 1 + 4 && entry[key_v.size()] == '\0') {
+			auto ret = std::array<char, 4>{};
+			std::memcpy(ret.data(), entry.data() + key_v.size() + 1, ret.size());
+			return ret;
+		}
+		// entries are padded to 4 bytes
+		kvd = kvd.subspan(std::min(kvd.size(), (sizeof(length) + length + 3) & ~std::size_t{3}));
+	}
+	return {};
+}
+
+struct BlockInfo {
+	std::uint32_t size{};
+	std::uint32_t extent{};
+};
+
+// VkFormat values (util does not depend on Vulkan): the formats Texture can upload
+constexpr std::optional<BlockInfo> block_info(std::uint32_t const vk_format) {
+	switch (vk_format) {
+	// R8G8B8A8 (unorm / srgb)
+	case 37:
+	case 43: return BlockInfo{.size = 4, .extent = 1};
+	// BC1 RGB / RGBA, BC4, ETC2 RGB / RGBA1
+	case 131:
+	case 132:
+	case 133:
+	case 134:
+	case 139:
+	case 140:
+	case 147:
+	case 148:
+	case 149:
+	case 150: return BlockInfo{.size = 8, .extent = 4};
+	// BC2, BC3, BC5, BC6H, BC7, ETC2 RGBA8, ASTC 4x4
+	case 135:
+	case 136:
+	case 137:
+	case 138:
+	case 141:
+	case 142:
+	case 143:
+	case 144:
+	case 145:
+	case 146:
+	case 151:
+	case 152:
+	case 157:
+	case 158: return BlockInfo{.size = 16, .extent = 4};
+	default: return {};
+	}
+}
+
+constexpr std::uint64_t level_size(BlockInfo const& block, glm::uvec2 const extent) {
+	auto const blocks_x = (extent.x + block.extent - 1) / block.extent;
+	auto const blocks_y = (extent.y + block.extent - 1) / block.extent;
+	return std::uint64_t{blocks_x} * blocks_y * block.size;
+}
+
+char const* unsupported_reason(Ktx2Header const& header) {
+	if (header.vk_format == 0) { return "Basis Universal payload (no transcoder)"; }
+	if (!block_info(header.vk_format)) { return "unsupported format"; }
+	if (header.supercompression_scheme != 0) { return "supercompressed payload"; }
+	if (header.pixel_width == 0 || header.pixel_height == 0 || header.pixel_depth > 1) { return "not a 2D image"; }
+	if (header.layer_count > 1 || header.face_count != 1) { return "array / cubemap"; }
+	return nullptr;
+}
+} // namespace
+
 void Image::Storage::Deleter::operator()(Storage const& image) const {
 	if (image.data) { stbi_image_free(const_cast<std::byte*>(image.data)); }
 }
@@ -18,10 +142,91 @@ Image::Image(std::span<std::byte const> compressed, std::string name) : m_name{s
 	m_extent = glm::uvec2{glm::ivec2{x, y}};
 }
 
+glm::uvec2 Image::peek(std::span<std::byte const> compressed) {
+	int x, y, channels;
+	if (!stbi_info_from_memory(reinterpret_cast<stbi_uc const*>(compressed.data()), static_cast<int>(compressed.size()), &x, &y, &channels)) { return {}; }
+	return glm::uvec2{glm::ivec2{x, y}};
+}
+
+bool Image::decode(std::span<std::byte const> compressed, std::span<std::byte> out_rgba) {
+	int x, y, channels;
+	// decode with the source's own channel count: stb would otherwise expand to RGBA into a second allocation
+	auto ptr = stbi_load_from_memory(reinterpret_cast<stbi_uc const*>(compressed.data()), static_cast<int>(compressed.size()), &x, &y, &channels, 0);
+	if (!ptr) { return false; }
+	auto const storage = Unique<Storage, Storage::Deleter>{Storage{.data = reinterpret_cast<std::byte const*>(ptr)}};
+	auto const pixels = static_cast<std::size_t>(x) * static_cast<std::size_t>(y);
+	if (out_rgba.size() < pixels * 4 || channels < 1 || channels > 4) { return false; }
+
+	if (channels == 4) {
+		std::memcpy(out_rgba.data(), ptr, pixels * 4);
+		return true;
+	}
+	auto const opaque = std::byte{0xff};
+	auto* out = out_rgba.data();
+	auto const* in = reinterpret_cast<std::byte const*>(ptr);
+	// grey (+ alpha) is replicated across RGB, as stb does when converting
+	bool const grey = channels < 3;
+	for (std::size_t i = 0; i < pixels; ++i, in += channels, out += 4) {
+		out[0] = in[0];
+		out[1] = grey ? in[0] : in[1];
+		out[2] = grey ? in[0] : in[2];
+		out[3] = channels == 2 ? in[1] : opaque;
+	}
+	return true;
+}
+
 auto Image::view() const -> View { return View{.bytes = m_storage.get().bytes(), .extent = m_extent}; }
 
 Image::operator bool() const {
 	if (m_extent.x == 0 || m_extent.y == 0) { return false; }
 	return m_storage.get().data != nullptr;
 }
+
+bool CompressedImage::is_ktx2(std::span<std::byte const> bytes) {
+	if (bytes.size() < sizeof(ktx2_identifier_v)) { return false; }
+	return std::memcmp(bytes.data(), ktx2_identifier_v, sizeof(ktx2_identifier_v)) == 0;
+}
+
+CompressedImage::CompressedImage(std::span<std::byte const> ktx2, std::string name) : CompressedImage(copy(ktx2), std::move(name)) {}
+
+CompressedImage::CompressedImage(ByteBuffer ktx2, std::string name) : m_name(std::move(name)), m_bytes(std::move(ktx2)) {
+	auto const bytes = m_bytes.span();
+	auto header = Ktx2Header{};
+	if (!is_ktx2(bytes) || !read(header, bytes, sizeof(ktx2_identifier_v))) {
+		logger::warn("[CompressedImage] Invalid KTX2 data: [{}]", m_name);
+		return;
+	}
+	if (auto const* reason = unsupported_reason(header)) {
+		logger::warn("[CompressedImage] Unsupported KTX2 image [{}]: {}", m_name, reason);
+		m_bytes = {};
+		return;
+	}
+
+	// level 0 is the base (largest) level; a level count of 0 requests runtime generation, which isn't possible for block compressed formats
+	auto const level_count = std::max(header.level_count, 1u);
+	// the smallest level is 1x1: further levels are invalid
+	if (level_count > static_cast<std::uint32_t>(std::bit_width(std::max(header.pixel_width, header.pixel_height)))) {
+		logger::warn("[CompressedImage] Invalid KTX2 level count [{}]: [{}]", m_name, header.level_count);
+		m_bytes = {};
+		return;
+	}
+	auto const block = *block_info(header.vk_format);
+	auto levels = std::vector<Level>{};
+	levels.reserve(level_count);
+	for (std::uint32_t i = 0; i < level_count; ++i) {
+		auto level = Ktx2Level{};
+		auto const extent = glm::uvec2{std::max(header.pixel_width >> i, 1u), std::max(header.pixel_height >> i, 1u)};
+		// uploads copy whole levels: sizes must match the block layout exactly
+		if (!read(level, bytes, ktx2_header_size_v + i * sizeof(Ktx2Level)) || level.byte_length != level_size(block, extent) ||
+			level.byte_offset > bytes.size() || level.byte_length > bytes.size() - level.byte_offset) {
+			logger::warn("[CompressedImage] Invalid KTX2 level index [{}]: [{}]", m_name, i);
+			m_bytes = {};
+			return;
+		}
+		levels.push_back(Level{.bytes = bytes.subspan(level.byte_offset, level.byte_length), .extent = extent});
+	}
+	m_levels = std::move(levels);
+	m_vk_format = header.vk_format;
+	if (auto const swizzle = find_swizzle(bytes, header)) { m_swizzle = *swizzle; }
+}
 } // namespace facade
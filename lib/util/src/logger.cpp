@@ -1,15 +1,26 @@
-#include <facade/util/async_queue.hpp>
 #include <facade/util/logger.hpp>
+#include <facade/util/ring_queue.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdio>
+#include <cstring>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <mutex>
+#include <shared_mutex>
 #include <thread>
-#include <unordered_map>
 #include <vector>
 
 #if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
 #include <Windows.h>
 #endif
 
@@ -23,36 +34,41 @@ struct Timestamp {
 };
 
 Timestamp make_timestamp() {
+	// localtime is slow (and not thread safe): convert once per second per thread
+	thread_local auto t_second = std::time_t{-1};
+	thread_local auto t_timestamp = Timestamp{};
 	auto const now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+	if (now == t_second) { return t_timestamp; }
+	auto tm = std::tm{};
+#if defined(_WIN32)
+	if (localtime_s(&tm, &now) != 0) { return {}; }
+#else
+	if (!localtime_r(&now, &tm)) { return {}; }
+#endif
 	auto ret = Timestamp{};
-	if (!std::strftime(ret.buffer, sizeof(ret.buffer), "%H:%M:%S", std::localtime(&now))) { return {}; }
+	if (!std::strftime(ret.buffer, sizeof(ret.buffer), "%H:%M:%S", &tm)) { return {}; }
+	t_second = now;
+	t_timestamp = ret;
 	return ret;
 }
 
-struct GetThreadId {
-	std::unordered_map<std::thread::id, int> ids{};
-	int next{};
-	std::mutex mutex{};
-
-	int operator()() {
-		auto lock = std::scoped_lock{mutex};
-		auto const tid = std::this_thread::get_id();
-		if (auto const it = ids.find(tid); it != ids.end()) { return it->second; }
-		auto const [it, _] = ids.insert_or_assign(tid, next++);
-		return it->second;
-	}
-};
+std::atomic<int> g_next_thread_id{};
+thread_local int const t_thread_id{g_next_thread_id++};
 
 class FileLogger : Pinned {
   public:
+	static constexpr std::size_t capacity_v{1024};
+
 	FileLogger(char const* path) : m_path(fs::absolute(path)), m_thread(std::jthread{[this](std::stop_token const& stop) { log_to_file(stop); }}) {}
 
 	~FileLogger() {
 		m_thread.request_stop();
-		flush_residue(queue.release());
+		m_thread.join();
+		flush_residue();
 	}
 
-	AsyncQueue<logger::Entry> queue{};
+	// lock-free: logging threads only block if the file thread falls a full queue behind
+	RingQueue<logger::Entry> queue{capacity_v};
 
   private:
 	void prepare_file() {
@@ -64,75 +80,131 @@ class FileLogger : Pinned {
 		}
 	}
 
-	void flush_residue(std::deque<logger::Entry> const& residue) {
-		auto file = std::ofstream{m_path, std::ios::app};
-		if (!file) { return; }
-		for (auto const& [message, _] : residue) { file << message << '\n'; }
+	void flush_residue() {
+		if (!m_file) { return; }
+		while (auto entry = queue.try_pop()) { m_file << entry->message << '\n'; }
+		m_file.flush();
 	}
 
 	void log_to_file(std::stop_token const& stop) {
 		prepare_file();
+		// the file stays open: entries are written in batches of whatever is queued, and flushed once per batch
+		m_file.open(m_path, std::ios::app);
 		while (auto entry = queue.pop(stop)) {
-			auto file = std::ofstream{m_path, std::ios::app};
-			file << entry->message << '\n';
+			do {
+				m_file << entry->message << '\n';
+			} while ((entry = queue.try_pop()));
+			m_file.flush();
 		}
 	}
 
 	fs::path m_path{};
+	std::ofstream m_file{};
 	std::jthread m_thread{};
 };
 
 struct Storage {
+	// fixed capacity ring of preallocated entries: the oldest is overwritten once full
 	struct Buffer {
 		logger::BufferSize size{};
 
-		std::vector<logger::Entry> entries{};
+		std::vector<logger::BufferEntry> entries{};
+		// total number of entries pushed
+		std::uint64_t pushed{};
+
+		explicit Buffer(logger::BufferSize const& size = {}) : size(size), entries(std::max(size.capacity, std::size_t{1})) {}
+
+		void push(logger::Entry const& entry) {
+			auto& out = entries[pushed++ % entries.size()];
+			auto const length = std::min(entry.message.size(), logger::BufferEntry::max_length_v);
+			std::memcpy(out.message, entry.message.data(), length);
+			out.message[length] = '\0';
+			if (length < entry.message.size()) { std::memcpy(out.message + length - 3, "...", 3); }
+			out.level = entry.level;
+		}
+
+		logger::BufferView view() const {
+			auto const all = std::span{entries};
+			if (pushed <= entries.size()) { return {.first = all.first(static_cast<std::size_t>(pushed))}; }
+			auto const oldest = static_cast<std::size_t>(pushed % entries.size());
+			return {.first = all.subspan(oldest), .second = all.first(oldest), .dropped = pushed - entries.size()};
+		}
 	};
 
 	Buffer buffer{};
 	std::optional<FileLogger> file_logger{};
 	std::mutex mutex{};
+	// guards file_logger: shared by logging threads, exclusive when it is created / destroyed
+	std::shared_mutex file_mutex{};
+	std::array<std::atomic<logger::Level>, static_cast<std::size_t>(logger::Sink::eCOUNT_)> levels{
+		logger::Level::eDebug,
+		logger::Level::eDebug,
+		logger::Level::eDebug,
+	};
+	// serializes set_level: g_max_level is derived from all levels
+	std::mutex levels_mutex{};
+
+	bool accepts(logger::Sink sink, logger::Level level) const { return level <= levels[static_cast<std::size_t>(sink)].load(std::memory_order_relaxed); }
 };
 
-GetThreadId get_thread_id{};
 Storage g_storage{};
 } // namespace
 
-int logger::thread_id() { return get_thread_id(); }
+int logger::thread_id() { return t_thread_id; }
 
 std::string logger::format(Level level, std::string_view const message) {
 	return fmt::format(fmt::runtime(g_format), fmt::arg("thread", thread_id()), fmt::arg("level", levels_v[static_cast<std::size_t>(level)]),
 					   fmt::arg("message", message), fmt::arg("timestamp", make_timestamp()));
 }
 
+void logger::set_level(Sink sink, Level level) {
+	auto lock = std::scoped_lock{g_storage.levels_mutex};
+	g_storage.levels[static_cast<std::size_t>(sink)] = level;
+	auto max_level = Level::eError;
+	for (auto const& sink_level : g_storage.levels) {
+		if (auto const level = sink_level.load(); level > max_level) { max_level = level; }
+	}
+	g_max_level = max_level;
+}
+
+logger::Level logger::level(Sink sink) { return g_storage.levels[static_cast<std::size_t>(sink)]; }
+
 void logger::log_to(Pipe pipe, Entry entry) {
-	auto* fd = pipe == Pipe::eStdErr ? stderr : stdout;
-	std::fprintf(fd, "%s\n", entry.message.c_str());
-	auto lock = std::scoped_lock{g_storage.mutex};
+	// entries are formatted by the caller: only the buffer is written under the global mutex
+	if (g_storage.accepts(Sink::eConsole, entry.level)) {
+		auto* fd = pipe == Pipe::eStdErr ? stderr : stdout;
+		std::fprintf(fd, "%s\n", entry.message.c_str());
 #if defined(_WIN32)
-	OutputDebugStringA(entry.message.c_str());
-	OutputDebugStringA("\n");
+		OutputDebugStringA(entry.message.c_str());
+		OutputDebugStringA("\n");
 #endif
-	if (g_storage.file_logger) { g_storage.file_logger->queue.push(entry); }
-	g_storage.buffer.entries.push_back(std::move(entry));
+	}
+	if (g_storage.accepts(Sink::eBuffer, entry.level)) {
+		// the buffer copies the message into its own storage
+		auto lock = std::scoped_lock{g_storage.mutex};
+		g_storage.buffer.push(entry);
+	}
+	if (!g_storage.accepts(Sink::eFile, entry.level)) { return; }
+	auto lock = std::shared_lock{g_storage.file_mutex};
+	if (g_storage.file_logger) { g_storage.file_logger->queue.push(std::move(entry)); }
 }
 
 logger::BufferSize const& logger::buffer_size() { return g_storage.buffer.size; }
 
 void logger::access_buffer(Accessor& accessor) {
 	auto lock = std::scoped_lock{g_storage.mutex};
-	accessor(g_storage.buffer.entries);
+	accessor(g_storage.buffer.view());
 }
 
 logger::Instance::Instance(logger::BufferSize const& buffer_size) {
-	auto lock = std::scoped_lock{g_storage.mutex};
+	auto lock = std::scoped_lock{g_storage.mutex, g_storage.file_mutex};
 	g_storage.buffer = Storage::Buffer{buffer_size};
 	g_storage.file_logger.emplace("facade.log");
 }
 
 logger::Instance::~Instance() {
-	auto lock = std::scoped_lock{g_storage.mutex};
+	auto lock = std::scoped_lock{g_storage.mutex, g_storage.file_mutex};
 	g_storage.file_logger.reset();
-	g_storage.buffer.entries.clear();
+	g_storage.buffer.pushed = 0;
 }
 } // namespace facade
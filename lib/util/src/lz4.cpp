@@ -0,0 +1,105 @@
+#include <facade/util/lz4.hpp>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace facade {
+namespace {
+// LZ4 block format: sequences of [token][literal length...][literals][offset:u16][match length...]
+constexpr std::size_t min_match_v{4};
+// the last match must start at least 12 bytes before the end, and the last 5 bytes are always literals
+constexpr std::size_t match_safe_distance_v{12};
+constexpr std::size_t last_literals_v{5};
+constexpr std::size_t max_offset_v{65535};
+constexpr int hash_bits_v{16};
+
+std::uint32_t read_u32(std::byte const* ptr) {
+	auto ret = std::uint32_t{};
+	std::memcpy(&ret, ptr, sizeof(ret));
+	return ret;
+}
+
+std::uint32_t hash(std::uint32_t sequence) { return (sequence * 2654435761u) >> (32 - hash_bits_v); }
+
+void write_length(std::vector<std::byte>& out, std::size_t length) {
+	for (; length >= 255; length -= 255) { out.push_back(std::byte{255}); }
+	out.push_back(static_cast<std::byte>(length));
+}
+
+void write_sequence(std::vector<std::byte>& out, std::span<std::byte const> literals, std::size_t offset, std::size_t match_length) {
+	auto const literal_nibble = std::min<std::size_t>(literals.size(), 15);
+	auto const match_nibble = match_length > 0 ? std::min<std::size_t>(match_length - min_match_v, 15) : 0;
+	out.push_back(static_cast<std::byte>(literal_nibble << 4 | match_nibble));
+	if (literal_nibble == 15) { write_length(out, literals.size() - 15); }
+	out.insert(out.end(), literals.begin(), literals.end());
+	if (match_length == 0) { return; }
+	out.push_back(static_cast<std::byte>(offset & 0xff));
+	out.push_back(static_cast<std::byte>(offset >> 8));
+	if (match_nibble == 15) { write_length(out, match_length - min_match_v - 15); }
+}
+
+bool read_length(std::span<std::byte const> block, std::size_t& out_index, std::size_t& out_length) {
+	for (auto byte = std::byte{255}; byte == std::byte{255};) {
+		if (out_index >= block.size()) { return false; }
+		byte = block[out_index++];
+		out_length += static_cast<std::size_t>(byte);
+	}
+	return true;
+}
+} // namespace
+
+std::vector<std::byte> lz4::compress(std::span<std::byte const> bytes) {
+	auto ret = std::vector<std::byte>{};
+	ret.reserve(max_compressed_size(bytes.size()));
+	auto table = std::array<std::uint32_t, std::size_t{1} << hash_bits_v>{};
+	table.fill(~std::uint32_t{});
+	auto anchor = std::size_t{};
+	if (bytes.size() > match_safe_distance_v) {
+		auto const match_limit = bytes.size() - match_safe_distance_v;
+		auto const length_limit = bytes.size() - last_literals_v;
+		for (std::size_t i = 0; i < match_limit;) {
+			auto const sequence = read_u32(bytes.data() + i);
+			auto& slot = table[hash(sequence)];
+			auto const candidate = std::size_t{slot};
+			slot = static_cast<std::uint32_t>(i);
+			if (candidate == ~std::uint32_t{} || i - candidate > max_offset_v || read_u32(bytes.data() + candidate) != sequence) {
+				++i;
+				continue;
+			}
+			auto length = min_match_v;
+			while (i + length < length_limit && bytes[candidate + length] == bytes[i + length]) { ++length; }
+			write_sequence(ret, bytes.subspan(anchor, i - anchor), i - candidate, length);
+			i += length;
+			anchor = i;
+		}
+	}
+	write_sequence(ret, bytes.subspan(anchor), 0, 0);
+	return ret;
+}
+
+bool lz4::decompress(std::span<std::byte const> block, std::span<std::byte> out_bytes) {
+	auto in = std::size_t{};
+	auto out = std::size_t{};
+	while (in < block.size()) {
+		auto const token = static_cast<std::size_t>(block[in++]);
+		auto literals = token >> 4;
+		if (literals == 15 && !read_length(block, in, literals)) { return false; }
+		if (literals > block.size() - in || literals > out_bytes.size() - out) { return false; }
+		std::memcpy(out_bytes.data() + out, block.data() + in, literals);
+		in += literals;
+		out += literals;
+		// the last sequence has no match
+		if (in == block.size()) { break; }
+		if (block.size() - in < 2) { return false; }
+		auto const offset = static_cast<std::size_t>(block[in]) | static_cast<std::size_t>(block[in + 1]) << 8;
+		in += 2;
+		auto length = token & 0xf;
+		if (length == 15 && !read_length(block, in, length)) { return false; }
+		length += min_match_v;
+		if (offset == 0 || offset > out || length > out_bytes.size() - out) { return false; }
+		// matches may overlap their output: copy byte by byte
+		for (std::size_t i = 0; i < length; ++i, ++out) { out_bytes[out] = out_bytes[out - offset]; }
+	}
+	return out == out_bytes.size();
+}
+} // namespace facade
@@ -0,0 +1,72 @@
+#include <facade/util/logger.hpp>
+#include <facade/util/mapped_file.hpp>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace facade {
+#if defined(_WIN32)
+MappedFile::MappedFile(char const* path, Access access) {
+	auto const flags = access == Access::eSequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+	auto file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		logger::warn("[MappedFile] Failed to open file: [{}]", path);
+		return;
+	}
+	auto size = LARGE_INTEGER{};
+	auto mapping = HANDLE{};
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0) { mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr); }
+	// the mapping keeps the file open
+	CloseHandle(file);
+	if (!mapping) {
+		logger::warn("[MappedFile] Failed to map file: [{}]", path);
+		return;
+	}
+	auto const* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	// the view keeps the mapping alive
+	CloseHandle(mapping);
+	if (!data) {
+		logger::warn("[MappedFile] Failed to map file: [{}]", path);
+		return;
+	}
+	m_mapping = Mapping{static_cast<std::byte const*>(data), static_cast<std::size_t>(size.QuadPart)};
+}
+
+void MappedFile::Mapping::Deleter::operator()(Mapping const& mapping) const {
+	if (mapping.data) { UnmapViewOfFile(mapping.data); }
+}
+#else
+MappedFile::MappedFile(char const* path, Access access) {
+	auto const fd = ::open(path, O_RDONLY);
+	if (fd < 0) {
+		logger::warn("[MappedFile] Failed to open file: [{}]", path);
+		return;
+	}
+	struct stat st {};
+	auto* data = MAP_FAILED;
+	if (::fstat(fd, &st) == 0 && st.st_size > 0) { data = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0); }
+	// the mapping keeps the file open
+	::close(fd);
+	if (data == MAP_FAILED) {
+		logger::warn("[MappedFile] Failed to map file: [{}]", path);
+		return;
+	}
+	if (access == Access::eSequential) {
+		// hints only: failures are harmless
+		::madvise(data, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+		::madvise(data, static_cast<std::size_t>(st.st_size), MADV_WILLNEED);
+	}
+	m_mapping = Mapping{static_cast<std::byte const*>(data), static_cast<std::size_t>(st.st_size)};
+}
+
+void MappedFile::Mapping::Deleter::operator()(Mapping const& mapping) const {
+	if (mapping.data) { ::munmap(const_cast<std::byte*>(mapping.data), mapping.size); }
+}
+#endif
+} // namespace facade
@@ -0,0 +1,268 @@
+#include <facade/util/atomic_file_writer.hpp>
+#include <facade/util/error.hpp>
+#include <facade/util/logger.hpp>
+#include <facade/util/lz4.hpp>
+#include <facade/util/pack_file.hpp>
+#include <facade/util/thread_pool.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+
+namespace facade {
+namespace {
+namespace fs = std::filesystem;
+
+constexpr char magic_v[4] = {'F', 'P', 'A', 'K'};
+constexpr std::uint32_t version_v{1};
+constexpr std::size_t data_align_v{16};
+constexpr auto no_root_v{~std::uint64_t{}};
+
+struct Header {
+	char magic[4]{};
+	std::uint32_t version{};
+	std::uint64_t entry_count{};
+	std::uint64_t strings_size{};
+	std::uint64_t data_offset{};
+	std::uint64_t data_size{};
+	std::uint64_t root{no_root_v};
+};
+
+constexpr std::uint64_t align(std::uint64_t size, std::uint64_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+
+constexpr std::size_t chunk_count(std::uint64_t size) { return static_cast<std::size_t>((size + PackFile::chunk_size_v - 1) / PackFile::chunk_size_v); }
+
+std::string normalize(std::string_view uri) { return fs::path{uri}.lexically_normal().generic_string(); }
+
+constexpr bool is_known(PackFile::Compression const compression) {
+	switch (compression) {
+	case PackFile::Compression::eNone:
+	case PackFile::Compression::eLz4: return true;
+	default: return false;
+	}
+}
+
+// shared with helper tasks, which may only run after the caller has finished all chunks
+struct Decompress {
+	struct Chunk {
+		std::span<std::byte const> block{};
+		std::span<std::byte> out{};
+	};
+
+	std::vector<Chunk> chunks{};
+	std::atomic<std::size_t> next{};
+	std::atomic<std::size_t> done{};
+	std::atomic<bool> failed{};
+
+	void run() {
+		for (auto i = next++; i < chunks.size(); i = next++) {
+			if (!lz4::decompress(chunks[i].block, chunks[i].out)) { failed = true; }
+			if (++done == chunks.size()) { done.notify_all(); }
+		}
+	}
+
+	bool wait() {
+		for (auto d = done.load(); d < chunks.size(); d = done.load()) { done.wait(d); }
+		return !failed;
+	}
+};
+} // namespace
+
+void PackFile::Writer::add(std::string uri, std::span<std::byte const> bytes, Compression compression) {
+	if (!is_known(compression)) { throw Error{fmt::format("Unknown pack file compression: {}", static_cast<int>(compression))}; }
+	auto entry = Entry{.uri = normalize(uri), .size = bytes.size()};
+	if (compression == Compression::eLz4 && bytes.size() > 0) {
+		auto const count = chunk_count(bytes.size());
+		auto sizes = std::vector<std::uint32_t>{};
+		auto blocks = std::vector<std::byte>{};
+		for (std::size_t i = 0; i < count; ++i) {
+			auto const block = lz4::compress(bytes.subspan(i * chunk_size_v, std::min(chunk_size_v, bytes.size() - i * chunk_size_v)));
+			sizes.push_back(static_cast<std::uint32_t>(block.size()));
+			blocks.insert(blocks.end(), block.begin(), block.end());
+		}
+		auto const table = std::as_bytes(std::span{sizes});
+		// incompressible data (PNG / JPG / KTX2 etc) is stored as-is
+		if (table.size() + blocks.size() < bytes.size()) {
+			entry.data.reserve(table.size() + blocks.size());
+			entry.data.insert(entry.data.end(), table.begin(), table.end());
+			entry.data.insert(entry.data.end(), blocks.begin(), blocks.end());
+			entry.compression = Compression::eLz4;
+		}
+	}
+	if (entry.compression == Compression::eNone) { entry.data.assign(bytes.begin(), bytes.end()); }
+	auto const it = std::find_if(m_entries.begin(), m_entries.end(), [&entry](Entry const& e) { return e.uri == entry.uri; });
+	if (it != m_entries.end()) {
+		*it = std::move(entry);
+	} else {
+		m_entries.push_back(std::move(entry));
+	}
+}
+
+bool PackFile::Writer::write(char const* path) const {
+	auto sorted = std::vector<Entry const*>{};
+	for (auto const& entry : m_entries) { sorted.push_back(&entry); }
+	std::sort(sorted.begin(), sorted.end(), [](Entry const* a, Entry const* b) { return a->uri < b->uri; });
+
+	auto header = Header{.version = version_v, .entry_count = sorted.size()};
+	std::memcpy(header.magic, magic_v, sizeof(magic_v));
+	auto index = std::vector<PackFile::Entry>{};
+	auto strings = std::string{};
+	auto const root = normalize(m_root);
+	for (auto const* entry : sorted) {
+		if (!m_root.empty() && entry->uri == root) { header.root = index.size(); }
+		index.push_back(PackFile::Entry{
+			.uri_offset = strings.size(),
+			.offset = align(header.data_size, data_align_v),
+			.stored_size = entry->data.size(),
+			.size = entry->size,
+			.uri_size = static_cast<std::uint32_t>(entry->uri.size()),
+			.compression = entry->compression,
+		});
+		strings += entry->uri;
+		header.data_size = index.back().offset + entry->data.size();
+	}
+	header.strings_size = strings.size();
+	header.data_offset = align(sizeof(Header) + std::span{index}.size_bytes() + strings.size(), data_align_v);
+
+	auto file = AtomicFileWriter{path};
+	file.write(std::as_bytes(std::span{&header, 1}));
+	file.write(std::as_bytes(std::span{index}));
+	file.write(std::as_bytes(std::span{strings}));
+	for (std::size_t i = 0; i < sorted.size(); ++i) {
+		file.pad_to(header.data_offset + index[i].offset);
+		file.write(sorted[i]->data);
+	}
+	return file.commit();
+}
+
+bool PackFile::is_pack(std::span<std::byte const> bytes) {
+	auto header = Header{};
+	if (bytes.size() < sizeof(header)) { return false; }
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	return std::memcmp(header.magic, magic_v, sizeof(magic_v)) == 0 && header.version == version_v;
+}
+
+PackFile::PackFile(char const* path) : m_file(path) {
+	auto const bytes = m_file.bytes();
+	auto const invalid = [&](std::string_view reason) {
+		logger::warn("[PackFile] Invalid pack file [{}]: {}", path, reason);
+		*this = {};
+	};
+	if (!is_pack(bytes)) {
+		invalid("bad header (or version mismatch)");
+		return;
+	}
+	auto header = Header{};
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	auto const index_size = header.entry_count * sizeof(Entry);
+	if (header.entry_count > bytes.size() / sizeof(Entry) || sizeof(Header) + index_size + header.strings_size > bytes.size()) {
+		invalid("truncated index");
+		return;
+	}
+	if (header.data_offset > bytes.size() || header.data_size > bytes.size() - header.data_offset) {
+		invalid("truncated data");
+		return;
+	}
+	// the mapping is page aligned and entries start right after the (8 byte aligned) header
+	m_index = {reinterpret_cast<Entry const*>(bytes.data() + sizeof(Header)), static_cast<std::size_t>(header.entry_count)};
+	m_strings = {reinterpret_cast<char const*>(bytes.data() + sizeof(Header) + index_size), static_cast<std::size_t>(header.strings_size)};
+	m_data = bytes.subspan(static_cast<std::size_t>(header.data_offset), static_cast<std::size_t>(header.data_size));
+	for (auto const& entry : m_index) {
+		bool const valid_uri = entry.uri_offset <= m_strings.size() && entry.uri_size <= m_strings.size() - entry.uri_offset;
+		if (!valid_uri || entry.offset > m_data.size() || entry.stored_size > m_data.size() - entry.offset) {
+			invalid("entry out of bounds");
+			return;
+		}
+		// load() decompresses anything that is not stored as-is
+		if (!is_known(entry.compression)) {
+			invalid("unknown compression");
+			return;
+		}
+		// load() allocates size bytes: stored entries are copied as-is, compressed ones are bounded by their chunk table
+		if (entry.compression == Compression::eNone && entry.stored_size != entry.size) {
+			invalid("stored size mismatch");
+			return;
+		}
+		if (entry.compression == Compression::eLz4 && chunk_count(entry.size) > entry.stored_size / sizeof(std::uint32_t)) {
+			invalid("size exceeds chunk table");
+			return;
+		}
+	}
+	if (header.root < m_index.size()) { m_root = uri(m_index[static_cast<std::size_t>(header.root)]); }
+}
+
+std::string_view PackFile::uri(Entry const& entry) const {
+	return {m_strings.data() + entry.uri_offset, static_cast<std::size_t>(entry.uri_size)};
+}
+
+PackFile::Entry const* PackFile::find(std::string_view in) const {
+	auto const target = normalize(in);
+	auto const it = std::lower_bound(m_index.begin(), m_index.end(), target, [this](Entry const& e, std::string_view u) { return uri(e) < u; });
+	if (it == m_index.end() || uri(*it) != target) { return nullptr; }
+	return &*it;
+}
+
+std::span<std::byte const> PackFile::stored(std::string_view uri) const {
+	auto const* entry = find(uri);
+	if (!entry || entry->compression != Compression::eNone) { return {}; }
+	return m_data.subspan(static_cast<std::size_t>(entry->offset), static_cast<std::size_t>(entry->stored_size));
+}
+
+ByteBuffer PackFile::load(std::string_view uri, ThreadPool* thread_pool) const {
+	auto const* entry = find(uri);
+	if (!entry) {
+		logger::warn("[PackFile] Entry not found: [{}]", uri);
+		return {};
+	}
+	auto const data = m_data.subspan(static_cast<std::size_t>(entry->offset), static_cast<std::size_t>(entry->stored_size));
+	auto ret = ByteBuffer::make(static_cast<std::size_t>(entry->size));
+	if (entry->compression == Compression::eNone) {
+		std::memcpy(ret.data(), data.data(), ret.size);
+		return ret;
+	}
+
+	auto const count = chunk_count(entry->size);
+	auto const table_size = count * sizeof(std::uint32_t);
+	if (data.size() < table_size) {
+		logger::warn("[PackFile] Corrupt entry: [{}]", uri);
+		return {};
+	}
+	auto job = std::make_shared<Decompress>();
+	job->chunks.reserve(count);
+	auto offset = table_size;
+	for (std::size_t i = 0; i < count; ++i) {
+		auto block_size = std::uint32_t{};
+		std::memcpy(&block_size, data.data() + i * sizeof(block_size), sizeof(block_size));
+		if (block_size > data.size() - offset) {
+			logger::warn("[PackFile] Corrupt entry: [{}]", uri);
+			return {};
+		}
+		auto const out_offset = i * chunk_size_v;
+		auto const out = std::span{ret.data() + out_offset, std::min(chunk_size_v, ret.size - out_offset)};
+		job->chunks.push_back({data.subspan(offset, block_size), out});
+		offset += block_size;
+	}
+	// the caller works through chunks too: never blocks on tasks that cannot start (eg when called from a busy pool)
+	if (thread_pool && count > 1) {
+		auto const helpers = std::min(count - 1, thread_pool->thread_count());
+		for (std::size_t i = 0; i < helpers; ++i) {
+			thread_pool->enqueue([job] { job->run(); });
+		}
+	}
+	job->run();
+	if (!job->wait()) {
+		logger::warn("[PackFile] Corrupt entry: [{}]", uri);
+		return {};
+	}
+	return ret;
+}
+
+PackDataProvider::PackDataProvider(char const* path, ThreadPool* thread_pool) : m_pack(std::make_shared<PackFile>(path)), m_thread_pool(thread_pool) {}
+
+ByteBuffer PackDataProvider::load(std::string_view uri) const { return m_pack->load(uri, m_thread_pool); }
+
+DataView PackDataProvider::view(std::string_view uri) const {
+	if (auto const stored = m_pack->stored(uri); !stored.empty()) { return DataView{stored, m_pack}; }
+	return DataView{load(uri)};
+}
+} // namespace facade
@@ -1,21 +1,167 @@
 #include <facade/util/error.hpp>
+#include <facade/util/logger.hpp>
 #include <facade/util/thread_pool.hpp>
 #include <algorithm>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#elif defined(__linux__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
 
 namespace facade {
-ThreadPool::ThreadPool(std::optional<std::uint32_t> const thread_count) {
+namespace {
+// the pool (and worker index) the calling thread belongs to, if any
+thread_local ThreadPool const* t_pool{};
+thread_local std::size_t t_worker{};
+// priority of the task being run by the calling thread: inherited by tasks it enqueues
+thread_local std::optional<ThreadPool::Priority> t_priority{};
+
+void set_thread_name([[maybe_unused]] std::string const& name) {
+	if (name.empty()) { return; }
+#if defined(_WIN32)
+	auto wide = std::wstring(name.begin(), name.end());
+	SetThreadDescription(GetCurrentThread(), wide.c_str());
+#elif defined(__linux__)
+	// limited to 16 characters including the null terminator
+	pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#elif defined(__APPLE__)
+	pthread_setname_np(name.c_str());
+#endif
+}
+
+bool set_thread_affinity([[maybe_unused]] std::uint32_t cpu) {
+#if defined(_WIN32)
+	if (cpu >= sizeof(DWORD_PTR) * 8) { return false; }
+	return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu) != 0;
+#elif defined(__linux__)
+	if (cpu >= CPU_SETSIZE) { return false; }
+	auto set = cpu_set_t{};
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	return false;
+#endif
+}
+} // namespace
+
+ThreadPool::ThreadPool(CreateInfo const& create_info) {
 	auto const hc = std::thread::hardware_concurrency();
-	auto const count = std::min(thread_count.value_or(hc), hc);
+	auto const count = std::min(create_info.thread_count.value_or(hc), hc);
 	if (count == 0) { return; }
 
-	auto agent = [queue = &m_queue](std::stop_token const& stop) {
-		while (auto task = queue->pop(stop)) { (*task)(); }
-	};
-	for (std::uint32_t i = 0; i < count; ++i) { m_threads.push_back(std::jthread{agent}); }
+	// all deques must exist before any worker starts stealing
+	for (std::uint32_t i = 0; i < count; ++i) { m_workers.push_back(std::make_unique<Worker>()); }
+	for (std::uint32_t i = 0; i < count; ++i) {
+		m_threads.push_back(std::jthread{[this, i, create_info](std::stop_token const& stop) { run(i, create_info, stop); }});
+	}
 }
 
 ThreadPool::~ThreadPool() {
 	for (auto& thread : m_threads) { thread.request_stop(); }
-	m_queue.release();
+	++m_queued;
+	m_queued.notify_all();
+	m_threads.clear();
+	if (m_workers.empty()) { return; }
+	// dropping a task completes its future / Task with an error, which may post continuations: drop until none are left
+	auto priority = Priority{};
+	while (pop(0, priority)) {}
+}
+
+bool ThreadPool::help() {
+	if (!is_worker()) { return false; }
+	auto priority = Priority{};
+	// a waiting task is not held up by lower priority work that an idle worker will run, else it could be waiting on that very work
+	auto const lowest = m_idle.load() > 0 ? t_priority.value_or(Priority::eLow) : Priority::eLow;
+	auto task = pop(t_worker, priority, lowest);
+	if (!task) { return false; }
+	execute(*task, priority);
+	return true;
+}
+
+bool ThreadPool::is_worker() const { return t_pool == this; }
+
+void ThreadPool::post(UniqueTask<void()> job, std::optional<Priority> priority) {
+	if (m_workers.empty()) {
+		// no workers: run on the calling thread
+		job();
+		return;
+	}
+	if (!priority) { priority = t_priority.value_or(Priority::eNormal); }
+	auto const lane = static_cast<std::size_t>(*priority);
+	// counted before being visible: a worker may briefly find nothing to pop, but the count never underflows
+	++m_queued;
+	if (is_worker() || !m_injected[lane].try_push(std::move(job))) {
+		auto& worker = *m_workers[is_worker() ? t_worker : m_next++ % m_workers.size()];
+		auto lock = std::scoped_lock{worker.mutex};
+		worker.tasks[lane].push_back(std::move(job));
+	}
+	m_queued.notify_one();
+}
+
+std::optional<UniqueTask<void()>> ThreadPool::pop(std::size_t const worker, Priority& out_priority, Priority const lowest) {
+	auto take = [this](Worker& victim, std::size_t lane, bool own) -> std::optional<UniqueTask<void()>> {
+		auto lock = std::scoped_lock{victim.mutex};
+		auto& tasks = victim.tasks[lane];
+		if (tasks.empty()) { return {}; }
+		// own tasks are run newest first (cache hot, depth first), stolen tasks oldest first
+		auto ret = own ? std::move(tasks.back()) : std::move(tasks.front());
+		if (own) {
+			tasks.pop_back();
+		} else {
+			tasks.pop_front();
+		}
+		--m_queued;
+		return ret;
+	};
+	// all queued tasks of a higher priority are found before any of a lower one
+	for (std::size_t lane = 0; lane <= static_cast<std::size_t>(lowest); ++lane) {
+		out_priority = static_cast<Priority>(lane);
+		if (auto ret = take(*m_workers[worker], lane, true)) { return ret; }
+		if (auto ret = m_injected[lane].try_pop()) {
+			--m_queued;
+			return ret;
+		}
+		for (std::size_t i = 1; i < m_workers.size(); ++i) {
+			if (auto ret = take(*m_workers[(worker + i) % m_workers.size()], lane, false)) { return ret; }
+		}
+	}
+	return {};
+}
+
+void ThreadPool::execute(UniqueTask<void()> const& job, Priority const priority) const {
+	// restored after: help() nests tasks of other priorities
+	auto const previous = std::exchange(t_priority, priority);
+	job();
+	t_priority = previous;
+}
+
+void ThreadPool::run(std::size_t const worker, CreateInfo const& create_info, std::stop_token const& stop) {
+	t_pool = this;
+	t_worker = worker;
+	if (!create_info.name.empty()) { set_thread_name(create_info.name + "-" + std::to_string(worker)); }
+	if (!create_info.affinity.empty()) {
+		auto const cpu = create_info.affinity[worker % create_info.affinity.size()];
+		if (!set_thread_affinity(cpu)) { logger::warn("[ThreadPool] Failed to set affinity of worker [{}] to CPU: [{}]", worker, cpu); }
+	}
+	auto priority = Priority{};
+	while (!stop.stop_requested()) {
+		if (auto task = pop(worker, priority)) {
+			execute(*task, priority);
+			continue;
+		}
+		++m_idle;
+		m_queued.wait(0);
+		--m_idle;
+	}
 }
 } // namespace facade
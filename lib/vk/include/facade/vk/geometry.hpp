@@ -1,7 +1,10 @@
 #pragma once
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <cassert>
+#include <cstdint>
 #include <span>
+#include <variant>
 #include <vector>
 
 namespace facade {
@@ -12,6 +15,11 @@ struct Vertex {
 	glm::vec2 uv{};
 };
 
+///
+/// \brief Default size of the grid cells that vertex attributes are quantized to by welding.
+///
+inline constexpr float weld_tolerance_v{1e-5f};
+
 struct Geometry {
 	struct Packed;
 
@@ -20,20 +28,89 @@ struct Geometry {
 
 	Geometry& append(std::span<Vertex const> vs, std::span<std::uint32_t const> is);
 	Geometry& append_cube(glm::vec3 size, glm::vec3 rgb = glm::vec3{1.0f}, glm::vec3 origin = {});
+
+	///
+	/// \brief Merge vertices whose attributes quantize to the same grid cells, and rebuild indices.
+	/// \param tolerance Size of grid cells (exact matching if 0)
+	/// \returns Reference to itself
+	///
+	/// Attributes rounding to the same cells differ by less than tolerance, but nearby values in adjacent cells are not merged.
+	/// Non-finite (and huge) attribute values are only merged with identical values.
+	/// Indices are generated if none are present.
+	///
+	Geometry& weld(float tolerance = weld_tolerance_v);
 };
 
 struct Geometry::Packed {
+	///
+	/// \brief Index storage: 16-bit if every index fits, else 32-bit.
+	///
+	class Indices {
+	  public:
+		///
+		/// \brief Maximum number of vertices addressable by 16-bit indices.
+		///
+		static constexpr std::size_t u16_vertices_v{0x10000};
+
+		///
+		/// \brief Make an instance, narrowing to 16-bit if vertex_count allows it.
+		/// \param indices 32-bit source indices
+		/// \param vertex_count Number of vertices indexed into
+		/// \returns Indices instance
+		///
+		static Indices make(std::span<std::uint32_t const> indices, std::size_t vertex_count);
+
+		Indices() = default;
+		Indices(std::vector<std::uint16_t> u16) : m_data(std::move(u16)) {}
+		Indices(std::vector<std::uint32_t> u32) : m_data(std::move(u32)) {}
+
+		bool is_u16() const { return std::holds_alternative<std::vector<std::uint16_t>>(m_data); }
+		std::size_t size() const { return std::visit([](auto const& vec) { return vec.size(); }, m_data); }
+		std::size_t size_bytes() const { return bytes().size(); }
+		bool empty() const { return size() == 0; }
+
+		///
+		/// \brief Obtain a read-only view of the stored indices as bytes.
+		/// \returns View into stored bytes (2 or 4 per index)
+		///
+		std::span<std::byte const> bytes() const { return std::visit([](auto const& vec) { return std::as_bytes(std::span{vec}); }, m_data); }
+
+		std::uint32_t operator[](std::size_t index) const {
+			return std::visit([index](auto const& vec) { return static_cast<std::uint32_t>(vec[index]); }, m_data);
+		}
+
+		///
+		/// \brief Obtain a widened copy of the stored indices.
+		/// \returns 32-bit copy of indices
+		///
+		std::vector<std::uint32_t> to_u32() const;
+
+	  private:
+		std::variant<std::vector<std::uint32_t>, std::vector<std::uint16_t>> m_data{};
+	};
+
 	std::vector<glm::vec3> positions{};
 	std::vector<glm::vec3> rgbs{};
 	std::vector<glm::vec3> normals{};
 	std::vector<glm::vec2> uvs{};
-	std::vector<std::uint32_t> indices{};
+	Indices indices{};
 
 	static Packed from(Geometry const& geometry);
 
+	///
+	/// \brief Merge vertices whose attributes quantize to the same grid cells, and rebuild indices.
+	/// \param tolerance Size of grid cells (exact matching if 0)
+	/// \returns Reference to itself
+	///
+	/// Attributes rounding to the same cells differ by less than tolerance, but nearby values in adjacent cells are not merged.
+	/// Non-finite (and huge) attribute values are only merged with identical values.
+	/// Indices are generated if none are present.
+	///
+	Packed& weld(float tolerance = weld_tolerance_v);
+
 	std::size_t size_bytes() const {
 		assert(positions.size() == rgbs.size() && positions.size() == normals.size() && positions.size() == uvs.size());
-		return positions.size() * (sizeof(positions) + sizeof(rgbs[0]) + sizeof(normals[0]) + sizeof(uvs[0])) + (indices.size() * sizeof(indices[0]));
+		return positions.size() * (sizeof(positions[0]) + sizeof(rgbs[0]) + sizeof(normals[0]) + sizeof(uvs[0])) + indices.size_bytes();
 	}
 };
 
@@ -0,0 +1,79 @@
+#pragma once
+#include <facade/vk/geometry.hpp>
+#include <facade/vk/meshlet.hpp>
+
+namespace facade {
+///
+/// \brief Reorders indexed triangle list geometry for post-transform cache, overdraw, and vertex fetch locality.
+///
+/// Triangles are first ordered by Tipsify (Sander et al, 2007), the resulting clusters are then sorted
+/// front-to-back from the mesh centroid to reduce overdraw, and finally vertices are renumbered in first-use order.
+/// Geometry already split into index ranges (eg meshlets) is optimized per range instead: see operator().
+///
+struct MeshOptimizer {
+	///
+	/// \brief Statistics and vertex remap table produced by an optimization pass.
+	///
+	struct Result {
+		///
+		/// \brief New index of each original vertex (empty if geometry was not modified).
+		///
+		std::vector<std::uint32_t> remap{};
+		std::size_t triangles{};
+		std::size_t misses_before{};
+		std::size_t misses_after{};
+
+		///
+		/// \brief Average cache miss ratio (transformed vertices per triangle) before optimization.
+		///
+		float acmr_before() const { return triangles == 0 ? 0.0f : static_cast<float>(misses_before) / static_cast<float>(triangles); }
+		///
+		/// \brief Average cache miss ratio (transformed vertices per triangle) after optimization.
+		///
+		float acmr_after() const { return triangles == 0 ? 0.0f : static_cast<float>(misses_after) / static_cast<float>(triangles); }
+	};
+
+	///
+	/// \brief Simulate a FIFO post-transform cache and count vertex cache misses.
+	/// \param indices Triangle list indices
+	/// \param vertex_count Number of vertices indexed into
+	/// \param cache_size Number of entries in the simulated cache
+	/// \returns Number of cache misses
+	///
+	static std::size_t cache_misses(std::span<std::uint32_t const> indices, std::size_t vertex_count, std::uint32_t cache_size);
+
+	///
+	/// \brief Reorder per-vertex attributes according to a remap table.
+	/// \param out_attributes Attributes to reorder (ignored if empty)
+	/// \param remap Remap table obtained from Result
+	///
+	template <typename T>
+	static void remap_vertices(std::vector<T>& out_attributes, std::span<std::uint32_t const> remap) {
+		if (out_attributes.empty() || remap.empty()) { return; }
+		assert(out_attributes.size() == remap.size());
+		auto ret = std::vector<T>(out_attributes.size());
+		for (std::size_t i = 0; i < remap.size(); ++i) { ret[remap[i]] = std::move(out_attributes[i]); }
+		out_attributes = std::move(ret);
+	}
+
+	///
+	/// \brief Simulated post-transform cache size.
+	///
+	std::uint32_t cache_size{16};
+	///
+	/// \brief Allowed ACMR ratio (relative to the containing cluster) when splitting clusters for overdraw sorting.
+	///
+	float overdraw_threshold{1.05f};
+
+	///
+	/// \brief Optimize geometry in place.
+	/// \param out_geometry Indexed triangle list geometry to optimize
+	/// \param ranges Disjoint triangle aligned index ranges whose triangles must stay within them (whole mesh if empty)
+	/// \returns Result containing the vertex remap table and cache statistics
+	///
+	/// Each range is ordered by Tipsify on its own, and overdraw sorting is skipped: ranges are culled and drawn as units.
+	/// Geometry that is not indexed or not a multiple of 3 indices is left untouched.
+	///
+	Result operator()(Geometry::Packed& out_geometry, std::span<IndexRange const> ranges = {}) const;
+};
+} // namespace facade
@@ -1,7 +1,9 @@
 #pragma once
+#include <facade/util/byte_buffer.hpp>
 #include <facade/vk/defer.hpp>
 #include <facade/vk/geometry.hpp>
 #include <facade/vk/gfx.hpp>
+#include <facade/vk/meshlet.hpp>
 #include <facade/vk/vertex_layout.hpp>
 #include <glm/vec4.hpp>
 
@@ -16,23 +18,56 @@ class MeshPrimitive {
 	struct Info {
 		std::uint32_t vertices{};
 		std::uint32_t indices{};
+		vk::IndexType index_type{vk::IndexType::eUint32};
 	};
 
 	using Joints = MeshJoints;
 
-	MeshPrimitive(Gfx const& gfx, Geometry::Packed const& geometry, Joints joints = {}, std::string name = "(Unnamed)");
+	///
+	/// \brief Vertex and index data laid out as in GPU buffers: uploaded with a single copy per buffer.
+	///
+	/// Positions, RGBs, normals, UVs, and indices are tightly packed; joints and weights (if skinned) follow at the next 16 byte boundary.
+	///
+	struct Blob {
+		std::span<std::byte const> bytes{};
+		Info info{};
+		bool skinned{};
+
+		///
+		/// \brief Pack geometry and joints into a blob.
+		/// \param out_bytes Storage to pack into (overwritten)
+		/// \param geometry Geometry to pack
+		/// \param joints Joints and weights to pack (if any)
+		/// \returns Blob viewing out_bytes
+		///
+		static Blob pack(ByteBuffer& out_bytes, Geometry::Packed const& geometry, Joints joints = {});
+
+		///
+		/// \brief Obtain the number of bytes the layout described by info and skinned occupies.
+		/// \returns Minimum size of bytes
+		///
+		std::size_t required_size() const;
+	};
+
+	MeshPrimitive(Gfx const& gfx, Geometry::Packed const& geometry, Joints joints = {}, std::string name = "(Unnamed)", std::vector<Meshlet> meshlets = {});
 	MeshPrimitive(Gfx const& gfx, Geometry const& geometry, Joints joints = {}, std::string name = "(Unnamed)");
+	MeshPrimitive(Gfx const& gfx, Blob const& blob, std::string name = "(Unnamed)", std::vector<Meshlet> meshlets = {});
 
 	std::string_view name() const { return m_name; }
 	Info info() const;
 	VertexLayout const& vertex_layout() const { return m_vlayout; }
 	bool has_joints() const { return m_jwbo.get().get().size > 0; }
 	std::uint32_t instance_binding() const { return m_instance_binding; }
+	std::span<Meshlet const> meshlets() const { return m_meshlets; }
 
 	void draw(vk::CommandBuffer cb, std::uint32_t instances = 1u) const;
+	void draw(vk::CommandBuffer cb, std::span<IndexRange const> ranges, std::uint32_t instances = 1u) const;
 
   private:
 	struct Uploader;
+
+	void bind(vk::CommandBuffer cb) const;
+
 	struct Offsets {
 		std::size_t positions{};
 		std::size_t rgbs{};
@@ -48,8 +83,10 @@ class MeshPrimitive {
 	Defer<UniqueBuffer> m_jwbo{};
 	Offsets m_offsets{};
 	std::string m_name{};
+	std::vector<Meshlet> m_meshlets{};
 	std::uint32_t m_vertices{};
 	std::uint32_t m_indices{};
 	std::uint32_t m_instance_binding{};
+	vk::IndexType m_index_type{vk::IndexType::eUint32};
 };
 } // namespace facade
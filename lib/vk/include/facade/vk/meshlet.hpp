@@ -0,0 +1,127 @@
+#pragma once
+#include <facade/vk/geometry.hpp>
+#include <glm/mat4x4.hpp>
+#include <array>
+
+namespace facade {
+///
+/// \brief Contiguous range of indices in an index buffer.
+///
+struct IndexRange {
+	std::uint32_t first_index{};
+	std::uint32_t index_count{};
+};
+
+///
+/// \brief Small cluster of adjacent triangles with bounds used for culling.
+///
+/// All bounds are in the mesh's local space.
+///
+struct Meshlet {
+	IndexRange indices{};
+	///
+	/// \brief Centre of the bounding sphere.
+	///
+	glm::vec3 centre{};
+	///
+	/// \brief Radius of the bounding sphere.
+	///
+	float radius{};
+	///
+	/// \brief Average normal of all triangles.
+	///
+	glm::vec3 cone_axis{};
+	///
+	/// \brief Sine of the normal cone's half angle; 1 if the cone is too wide to ever be backfacing.
+	///
+	float cone_cutoff{1.0f};
+
+	///
+	/// \brief Check if every triangle in the meshlet faces away from a (perspective) viewer.
+	/// \param camera Position of the viewer in local space
+	/// \returns true if the meshlet is entirely backfacing
+	///
+	bool backfacing(glm::vec3 const& camera) const;
+};
+
+///
+/// \brief Splits indexed triangle list geometry into meshlets.
+///
+/// Meshlets are grown greedily over shared vertices, and the index buffer is reordered
+/// such that each meshlet occupies a contiguous index range.
+///
+struct MeshletBuilder {
+	///
+	/// \brief Maximum unique vertices per meshlet.
+	///
+	std::uint32_t max_vertices{64};
+	///
+	/// \brief Maximum triangles per meshlet.
+	///
+	std::uint32_t max_triangles{124};
+
+	///
+	/// \brief Build meshlets and reorder indices in place.
+	/// \param out_geometry Indexed triangle list geometry to split
+	/// \returns Meshlets in index buffer order (empty if geometry is not an indexed triangle list)
+	///
+	std::vector<Meshlet> operator()(Geometry::Packed& out_geometry) const;
+};
+
+///
+/// \brief View frustum as six inward facing planes.
+///
+struct Frustum {
+	std::array<glm::vec4, 6> planes{};
+
+	///
+	/// \brief Extract frustum planes from a (model-)view-projection matrix.
+	/// \param mat Matrix to extract planes from
+	/// \returns Frustum in the space mat transforms from
+	///
+	static Frustum make(glm::mat4x4 const& mat);
+
+	///
+	/// \brief Check if a sphere is (at least partially) inside the frustum.
+	/// \param centre Centre of sphere
+	/// \param radius Radius of sphere
+	/// \returns false if the sphere is entirely outside the frustum
+	///
+	bool intersects(glm::vec3 const& centre, float radius) const;
+};
+
+///
+/// \brief Culls meshlets against the view frustum and (optionally) their normal cones.
+///
+class MeshletCuller {
+  public:
+	///
+	/// \brief Construct a culler for a view.
+	/// \param view_proj Combined view-projection matrix
+	/// \param camera World space position of the camera
+	/// \param backface Whether to cull backfacing meshlets (only correct for perspective views of single sided geometry)
+	///
+	MeshletCuller(glm::mat4x4 const& view_proj, glm::vec3 const& camera, bool backface);
+
+	///
+	/// \brief Obtain index ranges of meshlets visible to any instance.
+	/// \param out_ranges Visible (merged) index ranges to append to
+	/// \param meshlets Meshlets to cull
+	/// \param instances World matrices of all instances
+	/// \returns Number of meshlets culled
+	///
+	std::uint32_t operator()(std::vector<IndexRange>& out_ranges, std::span<Meshlet const> meshlets, std::span<glm::mat4x4 const> instances);
+
+  private:
+	struct View {
+		Frustum frustum{};
+		glm::vec3 camera{};
+		bool backface{};
+	};
+
+	glm::mat4x4 m_view_proj{};
+	glm::vec3 m_camera{};
+	bool m_backface{};
+	std::vector<View> m_views{};
+};
+} // namespace facade
@@ -1,8 +1,10 @@
 #pragma once
 #include <facade/util/colour_space.hpp>
 #include <facade/util/image.hpp>
+#include <facade/util/unique_task.hpp>
 #include <facade/vk/defer.hpp>
 #include <facade/vk/gfx.hpp>
+#include <memory>
 #include <span>
 
 namespace facade {
@@ -18,6 +20,42 @@ struct TextureCreateInfo {
 	std::string name{"(Unnamed)"};
 	bool mip_mapped{true};
 	ColourSpace colour_space{ColourSpace::eSrgb};
+	///
+	/// \brief Upload only the smallest mip levels on construction, and the rest via Texture::stream_next().
+	///
+	/// Only applies to compressed images with stored mip levels.
+	///
+	bool stream{};
+};
+
+///
+/// \brief RGBA image decompressed directly into mapped staging memory, uploaded without further CPU copies.
+///
+class StagedImage {
+  public:
+	StagedImage() = default;
+
+	///
+	/// \brief Construct an instance and decompress image data (PNG, JPG, TGA, etc).
+	/// \param gfx Gfx instance to allocate staging memory through
+	/// \param compressed Image data (compressed)
+	/// \param name Name of the image (optional)
+	///
+	StagedImage(Gfx const& gfx, std::span<std::byte const> compressed, std::string name = {});
+
+	std::string_view name() const { return m_name; }
+	glm::uvec2 extent() const { return m_extent; }
+	vk::Buffer buffer() const { return m_buffer.get().buffer; }
+
+	///
+	/// \brief Check if any image data is staged.
+	///
+	explicit operator bool() const { return m_buffer.get().buffer && m_extent.x > 0 && m_extent.y > 0; }
+
+  private:
+	std::string m_name{};
+	UniqueBuffer m_buffer{};
+	glm::uvec2 m_extent{};
 };
 
 class Sampler {
@@ -39,21 +77,81 @@ class Texture {
 	using CreateInfo = TextureCreateInfo;
 
 	static std::uint32_t mip_levels(vk::Extent2D extent);
+	static bool is_supported(Gfx const& gfx, vk::Format format);
+	static bool is_supported(Gfx const& gfx, CompressedImage::View image);
 
 	Texture(Gfx const& gfx, vk::Sampler sampler, Image::View image, CreateInfo info = {});
+	///
+	/// \brief Construct a Texture by uploading a staged image.
+	/// \param gfx Gfx instance
+	/// \param sampler Sampler to use
+	/// \param image Staged image to upload (must not be empty)
+	/// \param info Create info
+	///
+	Texture(Gfx const& gfx, vk::Sampler sampler, StagedImage const& image, CreateInfo info = {});
+	Texture(Gfx const& gfx, vk::Sampler sampler, CompressedImage::View image, CreateInfo info = {});
+	///
+	/// \brief Construct a Texture that can stream in its mip levels.
+	/// \param gfx Gfx instance
+	/// \param sampler Sampler to use
+	/// \param image Compressed image to (eventually) upload, shared with in-flight uploads
+	/// \param info Create info, the Texture is only streamed if info.stream is set
+	///
+	Texture(Gfx const& gfx, vk::Sampler sampler, std::shared_ptr<CompressedImage const> image, CreateInfo info = {});
 
 	std::string_view name() const { return m_name; }
 	ImageView view() const { return m_image.get().get().image_view(); }
 	DescriptorImage descriptor_image() const { return {*m_image.get().get().view, sampler}; }
 	std::uint32_t mip_levels() const { return m_info.mip_levels; }
+	vk::DeviceSize memory() const { return m_image.get().get().size; }
 	ColourSpace colour_space() const { return is_linear(m_info.format) ? ColourSpace::eLinear : ColourSpace::eSrgb; }
 
+	///
+	/// \brief Check if mip levels of this Texture are streamed in / evicted at runtime.
+	///
+	bool streamed() const { return m_stream != nullptr; }
+	///
+	/// \brief Check if more detailed mip levels can be streamed in.
+	///
+	bool streaming() const;
+	///
+	/// \brief Obtain the most detailed mip level currently bound (0 if not streamed).
+	///
+	std::uint32_t resident_level() const;
+	///
+	/// \brief Obtain the number of bound mip levels that can be evicted (and streamed back in later).
+	///
+	std::uint32_t evictable_levels() const;
+	///
+	/// \brief Obtain a task that rebuilds the image with level as its most detailed mip.
+	/// \param level Mip level to stream in or evict down to
+	/// \returns Task safe to run on any thread; empty if level is invalid / current, or a task is in flight
+	///
+	/// The Texture itself is not referenced by the task, and may be moved or destroyed while it runs.
+	/// The returned task must be run, else no further tasks will be handed out.
+	///
+	UniqueTask<void()> stream_to(std::uint32_t level);
+	///
+	/// \brief Obtain a task that streams in the next more detailed mip level.
+	///
+	UniqueTask<void()> stream_next();
+	///
+	/// \brief Swap in the image built by the last completed task (if any).
+	/// \returns true if a new image was swapped in
+	///
+	/// Must be called on the render thread, before descriptors using this Texture are written.
+	///
+	bool update_stream();
+
 	vk::Sampler sampler{};
 
   protected:
+	struct Stream;
+
 	Texture(Gfx const& gfx, vk::Sampler sampler, std::string name);
 
 	Defer<UniqueImage> m_image{};
+	std::shared_ptr<Stream> m_stream{};
 	Gfx m_gfx{};
 	ImageCreateInfo m_info{};
 	vk::ImageLayout m_layout{vk::ImageLayout::eUndefined};
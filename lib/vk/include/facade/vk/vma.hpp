@@ -10,8 +10,17 @@ using Pair = std::pair<T, U>;
 template <typename Type>
 concept BufferWrite = (!std::is_pointer_v<Type>) && std::is_trivially_destructible_v<Type>;
 
-constexpr vk::Format srgb_formats_v[] = {vk::Format::eR8G8B8A8Srgb, vk::Format::eB8G8R8A8Srgb, vk::Format::eA8B8G8R8SrgbPack32};
-constexpr vk::Format linear_formats_v[] = {vk::Format::eR8G8B8A8Unorm, vk::Format::eB8G8R8A8Unorm};
+constexpr vk::Format srgb_formats_v[] = {
+	vk::Format::eR8G8B8A8Srgb, vk::Format::eB8G8R8A8Srgb, vk::Format::eA8B8G8R8SrgbPack32, vk::Format::eBc1RgbSrgbBlock,
+	vk::Format::eBc1RgbaSrgbBlock, vk::Format::eBc2SrgbBlock, vk::Format::eBc3SrgbBlock, vk::Format::eBc7SrgbBlock,
+	vk::Format::eEtc2R8G8B8SrgbBlock, vk::Format::eEtc2R8G8B8A1SrgbBlock, vk::Format::eEtc2R8G8B8A8SrgbBlock, vk::Format::eAstc4x4SrgbBlock,
+};
+constexpr vk::Format linear_formats_v[] = {
+	vk::Format::eR8G8B8A8Unorm, vk::Format::eB8G8R8A8Unorm, vk::Format::eBc1RgbUnormBlock, vk::Format::eBc1RgbaUnormBlock,
+	vk::Format::eBc2UnormBlock, vk::Format::eBc3UnormBlock, vk::Format::eBc4UnormBlock, vk::Format::eBc5UnormBlock,
+	vk::Format::eBc6HUfloatBlock, vk::Format::eBc7UnormBlock, vk::Format::eEtc2R8G8B8UnormBlock, vk::Format::eEtc2R8G8B8A1UnormBlock,
+	vk::Format::eEtc2R8G8B8A8UnormBlock, vk::Format::eAstc4x4UnormBlock,
+};
 
 constexpr bool is_linear(vk::Format format) {
 	return std::find(std::begin(linear_formats_v), std::end(linear_formats_v), format) != std::end(linear_formats_v);
@@ -87,6 +96,7 @@ struct ImageCreateInfo {
 	std::uint32_t mip_levels{1};
 	std::uint32_t array_layers{1};
 	vk::SampleCountFlagBits samples{vk::SampleCountFlagBits::e1};
+	vk::ComponentMapping components{};
 };
 
 struct ImageBarrier {
@@ -116,7 +126,7 @@ struct Vma {
 	Unique<Buffer, Deleter> make_buffer(vk::BufferUsageFlags usage, vk::DeviceSize size, bool host_visible) const;
 	Unique<Image, Deleter> make_image(ImageCreateInfo const& info, vk::Extent2D extent, vk::ImageViewType type = vk::ImageViewType::e2D) const;
 	vk::UniqueImageView make_image_view(vk::Image const image, vk::Format const format, vk::ImageSubresourceRange isr = isr_v,
-										vk::ImageViewType type = vk::ImageViewType::e2D) const;
+										vk::ImageViewType type = vk::ImageViewType::e2D, vk::ComponentMapping components = {}) const;
 };
 
 struct Vma::Allocation {
@@ -144,6 +154,8 @@ struct Vma::Image {
 	vk::Image image{};
 	vk::UniqueImageView view{};
 	vk::Extent2D extent{};
+	// size of the allocation backing the image
+	vk::DeviceSize size{};
 
 	ImageView image_view() const { return {image, *view, extent}; }
 };
@@ -1,10 +1,89 @@
 #include <facade/util/flex_array.hpp>
+#include <facade/util/hash_combine.hpp>
 #include <facade/util/nvec3.hpp>
 #include <facade/vk/geometry.hpp>
 #include <array>
+#include <bit>
+#include <cmath>
 #include <optional>
+#include <unordered_map>
 
 namespace facade {
+namespace {
+// attributes are quantized to a grid of tolerance-sized cells, vertices in the same cells are merged
+// this is quantization, not a distance test: nearby values on either side of a cell boundary are not merged (adjacent cells are not probed)
+struct Welder {
+	// cells with larger magnitudes (and non-finite values) fall back to exact matching
+	static constexpr double max_cell_v{0x1p62};
+
+	float tolerance{};
+	std::size_t stride{};
+	std::vector<std::int64_t> keys{};
+
+	std::int64_t quantize(float const value) const {
+		if (tolerance > 0.0f) {
+			// double: huge values divided by tiny tolerances overflow float
+			auto const cell = std::round(static_cast<double>(value) / static_cast<double>(tolerance));
+			if (std::isfinite(cell) && std::abs(cell) < max_cell_v) { return static_cast<std::int64_t>(cell); }
+		}
+		// offset bit patterns beyond every cell so that the two never collide
+		return static_cast<std::int64_t>(max_cell_v) + std::bit_cast<std::uint32_t>(value);
+	}
+
+	template <glm::length_t Dim>
+	void add(glm::vec<Dim, float> const& attribute) {
+		for (glm::length_t i = 0; i < Dim; ++i) { keys.push_back(quantize(attribute[i])); }
+	}
+
+	std::span<std::int64_t const> row(std::uint32_t vertex) const { return std::span{keys}.subspan(vertex * stride, stride); }
+
+	struct Hasher {
+		Welder const* welder{};
+		std::size_t operator()(std::uint32_t const vertex) const {
+			auto ret = std::size_t{};
+			for (auto const key : welder->row(vertex)) { hash_combine(ret, key); }
+			return ret;
+		}
+	};
+
+	struct Equal {
+		Welder const* welder{};
+		bool operator()(std::uint32_t const a, std::uint32_t const b) const {
+			auto const ra = welder->row(a);
+			auto const rb = welder->row(b);
+			return std::equal(ra.begin(), ra.end(), rb.begin());
+		}
+	};
+
+	// returns the welded index of each vertex, unique vertices are numbered in order of first occurrence
+	std::vector<std::uint32_t> remap() const {
+		auto const count = stride == 0 ? std::size_t{} : keys.size() / stride;
+		auto map = std::unordered_map<std::uint32_t, std::uint32_t, Hasher, Equal>{count, Hasher{this}, Equal{this}};
+		auto ret = std::vector<std::uint32_t>(count);
+		for (std::uint32_t vertex = 0; vertex < count; ++vertex) {
+			auto const [it, _] = map.try_emplace(vertex, static_cast<std::uint32_t>(map.size()));
+			ret[vertex] = it->second;
+		}
+		return ret;
+	}
+};
+
+template <typename T>
+void compact(std::vector<T>& out, std::span<std::uint32_t const> remap) {
+	auto ret = std::vector<T>{};
+	for (std::size_t i = 0; i < out.size(); ++i) {
+		if (remap[i] == ret.size()) { ret.push_back(std::move(out[i])); }
+	}
+	out = std::move(ret);
+}
+
+std::vector<std::uint32_t> remap_indices(std::vector<std::uint32_t> indices, std::span<std::uint32_t const> remap) {
+	if (indices.empty()) { return {remap.begin(), remap.end()}; }
+	for (auto& index : indices) { index = remap[index]; }
+	return indices;
+}
+} // namespace
+
 Geometry& Geometry::append(std::span<Vertex const> vs, std::span<std::uint32_t const> is) {
 	auto const i_offset = static_cast<std::uint32_t>(vertices.size());
 	vertices.reserve(vertices.size() + vs.size());
@@ -66,6 +145,21 @@ Geometry& Geometry::append_cube(glm::vec3 size, glm::vec3 rgb, glm::vec3 const o
 	return append(vs, is);
 }
 
+Geometry& Geometry::weld(float const tolerance) {
+	auto welder = Welder{.tolerance = tolerance, .stride = 11};
+	welder.keys.reserve(vertices.size() * welder.stride);
+	for (auto const& vertex : vertices) {
+		welder.add(vertex.position);
+		welder.add(vertex.rgb);
+		welder.add(vertex.normal);
+		welder.add(vertex.uv);
+	}
+	auto const remap = welder.remap();
+	indices = remap_indices(std::move(indices), remap);
+	compact(vertices, remap);
+	return *this;
+}
+
 Geometry::Packed Geometry::Packed::from(Geometry const& geometry) {
 	auto ret = Packed{};
 	for (auto const& vertex : geometry.vertices) {
@@ -74,9 +168,43 @@ Geometry::Packed Geometry::Packed::from(Geometry const& geometry) {
 		ret.normals.push_back(vertex.normal);
 		ret.uvs.push_back(vertex.uv);
 	}
-	ret.indices = geometry.indices;
+	ret.indices = Indices::make(geometry.indices, geometry.vertices.size());
+	return ret;
+}
+
+auto Geometry::Packed::weld(float const tolerance) -> Packed& {
+	auto welder = Welder{.tolerance = tolerance, .stride = 11};
+	welder.keys.reserve(positions.size() * welder.stride);
+	for (std::size_t i = 0; i < positions.size(); ++i) {
+		welder.add(positions[i]);
+		welder.add(rgbs[i]);
+		welder.add(normals[i]);
+		welder.add(uvs[i]);
+	}
+	auto const remap = welder.remap();
+	auto const welded = remap_indices(indices.to_u32(), remap);
+	compact(positions, remap);
+	compact(rgbs, remap);
+	compact(normals, remap);
+	compact(uvs, remap);
+	indices = Indices::make(welded, positions.size());
+	return *this;
+}
+
+auto Geometry::Packed::Indices::make(std::span<std::uint32_t const> indices, std::size_t vertex_count) -> Indices {
+	if (vertex_count > u16_vertices_v) { return std::vector<std::uint32_t>{indices.begin(), indices.end()}; }
+	auto ret = std::vector<std::uint16_t>{};
+	ret.reserve(indices.size());
+	for (auto const index : indices) {
+		assert(index < u16_vertices_v);
+		ret.push_back(static_cast<std::uint16_t>(index));
+	}
 	return ret;
 }
+
+std::vector<std::uint32_t> Geometry::Packed::Indices::to_u32() const {
+	return std::visit([](auto const& vec) { return std::vector<std::uint32_t>{vec.begin(), vec.end()}; }, m_data);
+}
 } // namespace facade
 
 auto facade::make_cube(glm::vec3 size, glm::vec3 rgb, glm::vec3 const origin) -> Geometry {
@@ -131,6 +259,8 @@ auto facade::make_cubed_sphere(float diam, std::uint32_t quads_per_side, glm::ve
 	add_side(points, [](glm::vec3 const& p) { return nvec3(glm::rotate(p, glm::radians(-90.0f), up_v)); });
 	add_side(points, [](glm::vec3 const& p) { return nvec3(glm::rotate(p, glm::radians(90.0f), right_v)); });
 	add_side(points, [](glm::vec3 const& p) { return nvec3(glm::rotate(p, glm::radians(-90.0f), right_v)); });
+	// adjacent quads on each side share edge vertices
+	ret.weld();
 	return ret;
 }
 
@@ -0,0 +1,294 @@
+#include <facade/vk/mesh_optimizer.hpp>
+#include <glm/geometric.hpp>
+#include <algorithm>
+#include <optional>
+
+namespace facade {
+namespace {
+constexpr auto no_index_v = ~std::uint32_t{};
+
+struct FifoCache {
+	std::vector<std::uint32_t> timestamps{};
+	std::uint32_t time{};
+	std::uint32_t size{};
+
+	FifoCache(std::size_t vertex_count, std::uint32_t size) : timestamps(vertex_count), time(size + 1), size(size) {}
+
+	bool contains(std::uint32_t vertex) const { return time - timestamps[vertex] <= size; }
+
+	std::uint32_t age(std::uint32_t vertex) const { return time - timestamps[vertex]; }
+
+	// returns true on a miss
+	bool access(std::uint32_t vertex) {
+		if (contains(vertex)) { return false; }
+		timestamps[vertex] = time++;
+		return true;
+	}
+
+	void flush() { time += size + 1; }
+};
+
+struct Adjacency {
+	std::vector<std::uint32_t> offsets{};
+	std::vector<std::uint32_t> triangles{};
+	std::vector<std::uint32_t> live{};
+
+	static Adjacency make(std::span<std::uint32_t const> indices, std::size_t vertex_count) {
+		auto ret = Adjacency{};
+		ret.live.resize(vertex_count);
+		for (auto const index : indices) { ++ret.live[index]; }
+		ret.offsets.resize(vertex_count + 1);
+		for (std::size_t v = 0; v < vertex_count; ++v) { ret.offsets[v + 1] = ret.offsets[v] + ret.live[v]; }
+		ret.triangles.resize(indices.size());
+		auto cursor = std::vector<std::uint32_t>{ret.offsets.begin(), ret.offsets.end() - 1};
+		for (std::size_t i = 0; i < indices.size(); ++i) { ret.triangles[cursor[indices[i]]++] = static_cast<std::uint32_t>(i / 3); }
+		return ret;
+	}
+
+	std::span<std::uint32_t const> triangles_of(std::uint32_t vertex) const {
+		return std::span{triangles}.subspan(offsets[vertex], offsets[vertex + 1] - offsets[vertex]);
+	}
+};
+
+struct Tipsify {
+	std::span<std::uint32_t const> indices;
+	std::size_t vertex_count;
+	std::uint32_t cache_size;
+
+	std::vector<std::uint32_t> out{};
+	// triangle offsets where the fanning sequence had to restart
+	std::vector<std::size_t> boundaries{};
+
+	Adjacency adjacency{};
+	FifoCache cache{0, 0};
+	std::vector<std::uint32_t> dead_end{};
+	std::vector<std::uint32_t> candidates{};
+	std::uint32_t cursor{};
+
+	std::optional<std::uint32_t> skip_dead_end() {
+		while (!dead_end.empty()) {
+			auto const vertex = dead_end.back();
+			dead_end.pop_back();
+			if (adjacency.live[vertex] > 0) { return vertex; }
+		}
+		for (; cursor < vertex_count; ++cursor) {
+			if (adjacency.live[cursor] > 0) { return cursor; }
+		}
+		return {};
+	}
+
+	std::optional<std::uint32_t> next_vertex() {
+		auto ret = std::optional<std::uint32_t>{};
+		auto best = std::int64_t{-1};
+		for (auto const vertex : candidates) {
+			auto const live = adjacency.live[vertex];
+			if (live == 0) { continue; }
+			auto priority = std::int64_t{};
+			// prefer vertices that will still be in cache after emitting all their remaining triangles
+			if (cache.age(vertex) + 2 * live <= cache_size) { priority = cache.age(vertex); }
+			if (priority > best) {
+				best = priority;
+				ret = vertex;
+			}
+		}
+		if (ret) { return ret; }
+		if (auto const triangle = out.size() / 3; boundaries.back() != triangle) { boundaries.push_back(triangle); }
+		return skip_dead_end();
+	}
+
+	void operator()() {
+		auto const triangle_count = indices.size() / 3;
+		adjacency = Adjacency::make(indices, vertex_count);
+		cache = FifoCache{vertex_count, cache_size};
+		out.reserve(indices.size());
+		boundaries = {0};
+		auto emitted = std::vector<bool>(triangle_count);
+		auto fanning = skip_dead_end();
+		while (fanning) {
+			candidates.clear();
+			for (auto const triangle : adjacency.triangles_of(*fanning)) {
+				if (emitted[triangle]) { continue; }
+				emitted[triangle] = true;
+				for (std::size_t i = 0; i < 3; ++i) {
+					auto const vertex = indices[triangle * 3 + i];
+					out.push_back(vertex);
+					dead_end.push_back(vertex);
+					candidates.push_back(vertex);
+					--adjacency.live[vertex];
+					cache.access(vertex);
+				}
+			}
+			fanning = next_vertex();
+		}
+		if (boundaries.back() != triangle_count) { boundaries.push_back(triangle_count); }
+	}
+};
+
+// Tipsifies index ranges in place: vertices are renumbered locally so that adjacency is sized by the range, not the mesh.
+// small ranges may already be in a better order (eg meshlets grown over shared vertices): that is kept if Tipsify does not improve it
+struct RangeTipsify {
+	std::uint32_t cache_size;
+	std::vector<std::uint32_t> to_local;
+
+	std::vector<std::uint32_t> to_global{};
+	std::vector<std::uint32_t> local{};
+
+	void operator()(std::span<std::uint32_t> out_indices) {
+		to_global.clear();
+		local.clear();
+		for (auto const index : out_indices) {
+			if (to_local[index] == no_index_v) {
+				to_local[index] = static_cast<std::uint32_t>(to_global.size());
+				to_global.push_back(index);
+			}
+			local.push_back(to_local[index]);
+		}
+		auto tipsify = Tipsify{local, to_global.size(), cache_size};
+		tipsify();
+		if (MeshOptimizer::cache_misses(tipsify.out, to_global.size(), cache_size) < MeshOptimizer::cache_misses(local, to_global.size(), cache_size)) {
+			for (std::size_t i = 0; i < out_indices.size(); ++i) { out_indices[i] = to_global[tipsify.out[i]]; }
+		}
+		for (auto const index : to_global) { to_local[index] = no_index_v; }
+	}
+};
+
+struct OverdrawSorter {
+	std::span<glm::vec3 const> positions;
+	std::uint32_t cache_size;
+	float threshold;
+
+	struct Cluster {
+		std::size_t begin{};
+		std::size_t end{};
+		float sort_key{};
+	};
+
+	// split hard clusters wherever the running ACMR drops under the cluster's ACMR scaled by threshold
+	std::vector<std::size_t> soft_boundaries(std::span<std::uint32_t const> indices, std::span<std::size_t const> hard) const {
+		auto ret = std::vector<std::size_t>{0};
+		auto cache = FifoCache{positions.size(), cache_size};
+		for (std::size_t c = 0; c + 1 < hard.size(); ++c) {
+			auto const begin = hard[c];
+			auto const end = hard[c + 1];
+			cache.flush();
+			auto cluster_misses = std::size_t{};
+			for (auto t = begin; t < end; ++t) {
+				for (std::size_t i = 0; i < 3; ++i) { cluster_misses += cache.access(indices[t * 3 + i]) ? 1 : 0; }
+			}
+			auto const limit = threshold * static_cast<float>(cluster_misses) / static_cast<float>(end - begin);
+			cache.flush();
+			auto misses = std::size_t{};
+			auto start = begin;
+			for (auto t = begin; t < end; ++t) {
+				for (std::size_t i = 0; i < 3; ++i) { misses += cache.access(indices[t * 3 + i]) ? 1 : 0; }
+				if (t + 1 < end && static_cast<float>(misses) <= limit * static_cast<float>(t + 1 - start)) {
+					ret.push_back(t + 1);
+					start = t + 1;
+					misses = 0;
+					cache.flush();
+				}
+			}
+			ret.push_back(end);
+		}
+		return ret;
+	}
+
+	glm::vec3 centroid() const {
+		auto ret = glm::vec3{};
+		for (auto const& position : positions) { ret += position; }
+		return positions.empty() ? ret : ret / static_cast<float>(positions.size());
+	}
+
+	Cluster make_cluster(std::span<std::uint32_t const> indices, std::size_t begin, std::size_t end, glm::vec3 const& mesh_centroid) const {
+		auto centroid = glm::vec3{};
+		auto normal = glm::vec3{};
+		auto area = 0.0f;
+		for (auto t = begin; t < end; ++t) {
+			auto const& a = positions[indices[t * 3 + 0]];
+			auto const& b = positions[indices[t * 3 + 1]];
+			auto const& c = positions[indices[t * 3 + 2]];
+			auto const n = glm::cross(b - a, c - a);
+			auto const tri_area = glm::length(n);
+			centroid += (a + b + c) * (tri_area / 3.0f);
+			normal += n;
+			area += tri_area;
+		}
+		auto ret = Cluster{.begin = begin, .end = end};
+		if (area > 0.0f && glm::length(normal) > 0.0f) { ret.sort_key = glm::dot(centroid / area - mesh_centroid, glm::normalize(normal)); }
+		return ret;
+	}
+
+	void operator()(std::vector<std::uint32_t>& out_indices, std::span<std::size_t const> hard) const {
+		auto const boundaries = soft_boundaries(out_indices, hard);
+		auto const mesh_centroid = centroid();
+		auto clusters = std::vector<Cluster>{};
+		clusters.reserve(boundaries.size());
+		for (std::size_t i = 0; i + 1 < boundaries.size(); ++i) {
+			clusters.push_back(make_cluster(out_indices, boundaries[i], boundaries[i + 1], mesh_centroid));
+		}
+		// outward facing clusters on the hull are drawn first, occluding those behind them
+		std::stable_sort(clusters.begin(), clusters.end(), [](Cluster const& a, Cluster const& b) { return a.sort_key > b.sort_key; });
+		auto ret = std::vector<std::uint32_t>{};
+		ret.reserve(out_indices.size());
+		for (auto const& cluster : clusters) {
+			ret.insert(ret.end(), out_indices.begin() + static_cast<std::ptrdiff_t>(cluster.begin * 3),
+					   out_indices.begin() + static_cast<std::ptrdiff_t>(cluster.end * 3));
+		}
+		out_indices = std::move(ret);
+	}
+};
+
+std::vector<std::uint32_t> optimize_fetch(std::vector<std::uint32_t>& out_indices, std::size_t vertex_count) {
+	auto ret = std::vector<std::uint32_t>(vertex_count, no_index_v);
+	auto next = std::uint32_t{};
+	for (auto& index : out_indices) {
+		if (ret[index] == no_index_v) { ret[index] = next++; }
+		index = ret[index];
+	}
+	// unreferenced vertices are moved to the end
+	for (auto& index : ret) {
+		if (index == no_index_v) { index = next++; }
+	}
+	return ret;
+}
+} // namespace
+
+std::size_t MeshOptimizer::cache_misses(std::span<std::uint32_t const> indices, std::size_t vertex_count, std::uint32_t cache_size) {
+	auto cache = FifoCache{vertex_count, cache_size};
+	auto ret = std::size_t{};
+	for (auto const index : indices) { ret += cache.access(index) ? 1 : 0; }
+	return ret;
+}
+
+auto MeshOptimizer::operator()(Geometry::Packed& out_geometry, std::span<IndexRange const> ranges) const -> Result {
+	auto const vertex_count = out_geometry.positions.size();
+	auto ret = Result{};
+	if (out_geometry.indices.empty() || out_geometry.indices.size() % 3 != 0 || vertex_count == 0) { return ret; }
+
+	auto indices = out_geometry.indices.to_u32();
+	ret.triangles = indices.size() / 3;
+	ret.misses_before = cache_misses(indices, vertex_count, cache_size);
+
+	if (ranges.empty()) {
+		auto tipsify = Tipsify{indices, vertex_count, cache_size};
+		tipsify();
+		indices = std::move(tipsify.out);
+		OverdrawSorter{out_geometry.positions, cache_size, overdraw_threshold}(indices, tipsify.boundaries);
+	} else {
+		auto range_tipsify = RangeTipsify{cache_size, std::vector<std::uint32_t>(vertex_count, no_index_v)};
+		for (auto const& range : ranges) {
+			assert(range.first_index % 3 == 0 && range.index_count % 3 == 0 && range.first_index + range.index_count <= indices.size());
+			range_tipsify(std::span{indices}.subspan(range.first_index, range.index_count));
+		}
+	}
+	ret.remap = optimize_fetch(indices, vertex_count);
+
+	remap_vertices(out_geometry.positions, ret.remap);
+	remap_vertices(out_geometry.rgbs, ret.remap);
+	remap_vertices(out_geometry.normals, ret.remap);
+	remap_vertices(out_geometry.uvs, ret.remap);
+	ret.misses_after = cache_misses(indices, vertex_count, cache_size);
+	out_geometry.indices = Geometry::Packed::Indices::make(indices, vertex_count);
+	return ret;
+}
+} // namespace facade
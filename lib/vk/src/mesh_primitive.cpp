@@ -23,6 +23,29 @@ struct Writer {
 	}
 };
 
+struct BlobLayout {
+	static constexpr std::size_t vertex_size_v{3 * sizeof(glm::vec3) + sizeof(glm::vec2)};
+	static constexpr std::size_t joints_align_v{16};
+
+	// offset of the indices, following the vertices
+	std::size_t index_offset{};
+	// size of the combined vertex + index buffer
+	std::size_t vibo_size{};
+	// offset of the joints and weights (skinned only)
+	std::size_t joints{};
+	std::size_t size{};
+
+	static BlobLayout make(MeshPrimitive::Info const& info, bool skinned) {
+		auto const index_size = info.index_type == vk::IndexType::eUint16 ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+		auto ret = BlobLayout{};
+		ret.index_offset = std::size_t{info.vertices} * vertex_size_v;
+		ret.vibo_size = ret.index_offset + std::size_t{info.indices} * index_size;
+		ret.joints = (ret.vibo_size + joints_align_v - 1) & ~(joints_align_v - 1);
+		ret.size = skinned ? ret.joints + std::size_t{info.vertices} * (sizeof(glm::uvec4) + sizeof(glm::vec4)) : ret.vibo_size;
+		return ret;
+	}
+};
+
 VertexLayout common_vertex_layout() {
 	auto ret = VertexLayout{};
 	// position
@@ -87,10 +110,43 @@ struct MeshPrimitive::Uploader {
 		out.m_instance_binding = 6u;
 	}
 
+	void operator()(Blob const& blob) {
+		auto const layout = BlobLayout::make(blob.info, blob.skinned);
+		if (blob.bytes.size() < layout.size) { throw Error{fmt::format("Truncated mesh data: [{}]", out.m_name)}; }
+		out.m_vertices = blob.info.vertices;
+		out.m_indices = blob.info.indices;
+		out.m_index_type = blob.info.index_type;
+		auto const vertices = std::size_t{blob.info.vertices};
+		out.m_offsets.positions = 0;
+		out.m_offsets.rgbs = vertices * sizeof(glm::vec3);
+		out.m_offsets.normals = vertices * 2 * sizeof(glm::vec3);
+		out.m_offsets.uvs = vertices * 3 * sizeof(glm::vec3);
+		out.m_offsets.indices = layout.index_offset;
+		out.m_offsets.joints = 0;
+		out.m_offsets.weights = vertices * sizeof(glm::uvec4);
+		{
+			auto staging = FlexArray<UniqueBuffer, 2>{};
+			auto cmd = Cmd{gfx, vk::PipelineStageFlagBits::eTopOfPipe};
+			staging.insert(upload(cmd.cb, out.m_vibo, vi_flags_v, blob.bytes.first(layout.vibo_size)));
+			if (blob.skinned) { staging.insert(upload(cmd.cb, out.m_jwbo, v_flags_v, blob.bytes.subspan(layout.joints, layout.size - layout.joints))); }
+		}
+		out.m_vlayout = blob.skinned ? skinned_vertex_layout() : instanced_vertex_layout();
+		out.m_instance_binding = 6u;
+	}
+
+	[[nodiscard]] UniqueBuffer upload(vk::CommandBuffer cb, Defer<UniqueBuffer>& out_buffer, vk::BufferUsageFlags usage, std::span<std::byte const> bytes) {
+		out_buffer.swap(gfx.vma.make_buffer(usage, bytes.size(), false));
+		auto staging = gfx.vma.make_buffer(vk::BufferUsageFlagBits::eTransferSrc, bytes.size(), true);
+		std::memcpy(staging.get().ptr, bytes.data(), bytes.size());
+		cb.copyBuffer(staging.get().buffer, out_buffer.get().get().buffer, vk::BufferCopy{{}, {}, bytes.size()});
+		return staging;
+	}
+
 	[[nodiscard]] UniqueBuffer upload(vk::CommandBuffer cb, Geometry::Packed const& geometry) {
-		auto const indices = std::span<std::uint32_t const>{geometry.indices};
+		auto const& indices = geometry.indices;
 		out.m_vertices = static_cast<std::uint32_t>(geometry.positions.size());
 		out.m_indices = static_cast<std::uint32_t>(indices.size());
+		out.m_index_type = indices.is_u16() ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
 		auto const size = geometry.size_bytes();
 		out.m_vibo.swap(gfx.vma.make_buffer(vi_flags_v, size, false));
 		auto staging = gfx.vma.make_buffer(vk::BufferUsageFlagBits::eTransferSrc, size, true);
@@ -99,7 +155,8 @@ struct MeshPrimitive::Uploader {
 		out.m_offsets.rgbs = writer(std::span{geometry.rgbs});
 		out.m_offsets.normals = writer(std::span{geometry.normals});
 		out.m_offsets.uvs = writer(std::span{geometry.uvs});
-		if (!indices.empty()) { out.m_offsets.indices = writer(indices); }
+		// all vertex attributes are float-aligned, so the index offset satisfies both u16 and u32 alignment
+		if (!indices.empty()) { out.m_offsets.indices = writer(indices.bytes()); }
 		cb.copyBuffer(staging.get().buffer, out.m_vibo.get().get().buffer, vk::BufferCopy{{}, {}, size});
 		return staging;
 	}
@@ -117,17 +174,71 @@ struct MeshPrimitive::Uploader {
 	}
 };
 
-MeshPrimitive::MeshPrimitive(Gfx const& gfx, Geometry::Packed const& geometry, Joints joints, std::string name)
-	: m_vibo(gfx.shared->defer_queue), m_jwbo(gfx.shared->defer_queue), m_name(std::move(name)) {
+MeshPrimitive::MeshPrimitive(Gfx const& gfx, Geometry::Packed const& geometry, Joints joints, std::string name, std::vector<Meshlet> meshlets)
+	: m_vibo(gfx.shared->defer_queue), m_jwbo(gfx.shared->defer_queue), m_name(std::move(name)), m_meshlets(std::move(meshlets)) {
+	// skinned vertices move away from their bind pose bounds
+	assert(m_meshlets.empty() || joints.joints.empty());
 	Uploader{gfx, *this}(geometry, joints);
 }
 
 MeshPrimitive::MeshPrimitive(Gfx const& gfx, Geometry const& geometry, Joints joints, std::string name)
 	: MeshPrimitive{gfx, Geometry::Packed::from(geometry), joints, std::move(name)} {}
 
-auto MeshPrimitive::info() const -> Info { return {m_vertices, m_indices}; }
+MeshPrimitive::MeshPrimitive(Gfx const& gfx, Blob const& blob, std::string name, std::vector<Meshlet> meshlets)
+	: m_vibo(gfx.shared->defer_queue), m_jwbo(gfx.shared->defer_queue), m_name(std::move(name)), m_meshlets(std::move(meshlets)) {
+	assert(m_meshlets.empty() || !blob.skinned);
+	Uploader{gfx, *this}(blob);
+}
+
+auto MeshPrimitive::Blob::pack(ByteBuffer& out_bytes, Geometry::Packed const& geometry, Joints joints) -> Blob {
+	assert(joints.joints.size() == joints.weights.size() && (joints.joints.empty() || joints.joints.size() == geometry.positions.size()));
+	auto const& indices = geometry.indices;
+	auto ret = Blob{.skinned = !joints.joints.empty()};
+	ret.info.vertices = static_cast<std::uint32_t>(geometry.positions.size());
+	ret.info.indices = static_cast<std::uint32_t>(indices.size());
+	ret.info.index_type = indices.is_u16() ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+	auto const layout = BlobLayout::make(ret.info, ret.skinned);
+	out_bytes = ByteBuffer::make(layout.size);
+	auto* out = out_bytes.data();
+	auto write = [&out](std::span<std::byte const> bytes) {
+		std::memcpy(out, bytes.data(), bytes.size());
+		out += bytes.size();
+	};
+	write(std::as_bytes(std::span{geometry.positions}));
+	write(std::as_bytes(std::span{geometry.rgbs}));
+	write(std::as_bytes(std::span{geometry.normals}));
+	write(std::as_bytes(std::span{geometry.uvs}));
+	write(indices.bytes());
+	if (ret.skinned) {
+		std::memset(out, 0, layout.joints - layout.vibo_size);
+		out = out_bytes.data() + layout.joints;
+		write(std::as_bytes(joints.joints));
+		write(std::as_bytes(joints.weights));
+	}
+	ret.bytes = out_bytes.span();
+	return ret;
+}
+
+std::size_t MeshPrimitive::Blob::required_size() const { return BlobLayout::make(info, skinned).size; }
+
+auto MeshPrimitive::info() const -> Info { return {m_vertices, m_indices, m_index_type}; }
 
 void MeshPrimitive::draw(vk::CommandBuffer cb, std::uint32_t instances) const {
+	bind(cb);
+	if (m_indices > 0) {
+		cb.drawIndexed(m_indices, instances, 0u, 0u, 0u);
+	} else {
+		cb.draw(m_vertices, instances, 0u, 0u);
+	}
+}
+
+void MeshPrimitive::draw(vk::CommandBuffer cb, std::span<IndexRange const> ranges, std::uint32_t instances) const {
+	assert(m_indices > 0);
+	bind(cb);
+	for (auto const& range : ranges) { cb.drawIndexed(range.index_count, instances, range.first_index, 0u, 0u); }
+}
+
+void MeshPrimitive::bind(vk::CommandBuffer cb) const {
 	auto const& v = m_vibo.get().get();
 	vk::Buffer const buffers[] = {v.buffer, v.buffer, v.buffer, v.buffer};
 	vk::DeviceSize const offsets[] = {m_offsets.positions, m_offsets.rgbs, m_offsets.normals, m_offsets.uvs};
@@ -137,11 +248,6 @@ void MeshPrimitive::draw(vk::CommandBuffer cb, std::uint32_t instances) const {
 		vk::DeviceSize const offsets[] = {m_offsets.joints, m_offsets.weights};
 		cb.bindVertexBuffers(4u, buffers, offsets);
 	}
-	if (m_indices > 0) {
-		cb.bindIndexBuffer(v.buffer, m_offsets.indices, vk::IndexType::eUint32);
-		cb.drawIndexed(m_indices, instances, 0u, 0u, 0u);
-	} else {
-		cb.draw(m_vertices, instances, 0u, 0u);
-	}
+	if (m_indices > 0) { cb.bindIndexBuffer(v.buffer, m_offsets.indices, m_index_type); }
 }
 } // namespace facade
@@ -0,0 +1,176 @@
+#include <facade/vk/meshlet.hpp>
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace facade {
+namespace {
+constexpr auto no_meshlet_v = ~std::uint32_t{};
+// normal cones wider than this (dot of the outermost normal with the axis) are never backfacing
+constexpr auto min_cone_dot_v{0.1f};
+
+struct VertexTriangles {
+	std::vector<std::uint32_t> offsets{};
+	std::vector<std::uint32_t> triangles{};
+
+	static VertexTriangles make(std::span<std::uint32_t const> indices, std::size_t vertex_count) {
+		auto ret = VertexTriangles{};
+		ret.offsets.resize(vertex_count + 1);
+		for (auto const index : indices) { ++ret.offsets[index + 1]; }
+		for (std::size_t v = 0; v < vertex_count; ++v) { ret.offsets[v + 1] += ret.offsets[v]; }
+		ret.triangles.resize(indices.size());
+		auto cursor = std::vector<std::uint32_t>{ret.offsets.begin(), ret.offsets.end() - 1};
+		for (std::size_t i = 0; i < indices.size(); ++i) { ret.triangles[cursor[indices[i]]++] = static_cast<std::uint32_t>(i / 3); }
+		return ret;
+	}
+
+	std::span<std::uint32_t const> of(std::uint32_t vertex) const {
+		return std::span{triangles}.subspan(offsets[vertex], offsets[vertex + 1] - offsets[vertex]);
+	}
+};
+
+Meshlet make_meshlet(std::span<glm::vec3 const> positions, std::span<std::uint32_t const> indices, std::span<std::uint32_t const> vertices, IndexRange range) {
+	auto ret = Meshlet{.indices = range};
+	for (auto const vertex : vertices) { ret.centre += positions[vertex]; }
+	ret.centre /= static_cast<float>(vertices.size());
+	for (auto const vertex : vertices) { ret.radius = std::max(ret.radius, glm::length(positions[vertex] - ret.centre)); }
+
+	auto normals = std::vector<glm::vec3>{};
+	normals.reserve(range.index_count / 3);
+	auto axis = glm::vec3{};
+	for (auto i = range.first_index; i < range.first_index + range.index_count; i += 3) {
+		auto const& a = positions[indices[i + 0]];
+		auto const& b = positions[indices[i + 1]];
+		auto const& c = positions[indices[i + 2]];
+		auto const n = glm::cross(b - a, c - a);
+		// degenerate triangles are never rasterized
+		if (auto const length = glm::length(n); length > 0.0f) {
+			normals.push_back(n / length);
+			axis += normals.back();
+		}
+	}
+	if (normals.empty() || glm::length(axis) <= 0.0f) { return ret; }
+	ret.cone_axis = glm::normalize(axis);
+	auto min_dot = 1.0f;
+	for (auto const& n : normals) { min_dot = std::min(min_dot, glm::dot(n, ret.cone_axis)); }
+	if (min_dot > min_cone_dot_v) { ret.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot); }
+	return ret;
+}
+} // namespace
+
+bool Meshlet::backfacing(glm::vec3 const& camera) const {
+	if (cone_cutoff >= 1.0f) { return false; }
+	auto const to_centre = centre - camera;
+	return glm::dot(to_centre, cone_axis) >= cone_cutoff * glm::length(to_centre) + radius;
+}
+
+std::vector<Meshlet> MeshletBuilder::operator()(Geometry::Packed& out_geometry) const {
+	auto const vertex_count = out_geometry.positions.size();
+	if (out_geometry.indices.empty() || out_geometry.indices.size() % 3 != 0 || vertex_count == 0) { return {}; }
+	if (max_triangles == 0 || max_vertices < 3) { return {}; }
+
+	auto const indices = out_geometry.indices.to_u32();
+	auto const triangle_count = indices.size() / 3;
+	auto const adjacency = VertexTriangles::make(indices, vertex_count);
+	auto emitted = std::vector<bool>(triangle_count);
+	auto owner = std::vector<std::uint32_t>(vertex_count, no_meshlet_v);
+	auto out = std::vector<std::uint32_t>{};
+	out.reserve(indices.size());
+	auto vertices = std::vector<std::uint32_t>{};
+	auto queue = std::vector<std::uint32_t>{};
+	auto ret = std::vector<Meshlet>{};
+
+	for (std::size_t seed = 0; seed < triangle_count;) {
+		if (emitted[seed]) {
+			++seed;
+			continue;
+		}
+		auto const id = static_cast<std::uint32_t>(ret.size());
+		auto const first_index = static_cast<std::uint32_t>(out.size());
+		vertices.clear();
+		queue.clear();
+		queue.push_back(static_cast<std::uint32_t>(seed));
+		// grow breadth-first over triangles sharing vertices with the meshlet
+		for (std::size_t head = 0, triangles = 0; head < queue.size() && triangles < max_triangles; ++head) {
+			auto const triangle = queue[head];
+			if (emitted[triangle]) { continue; }
+			auto const corners = std::span{indices}.subspan(triangle * 3, 3);
+			auto const fresh = std::count_if(corners.begin(), corners.end(), [&](std::uint32_t v) { return owner[v] != id; });
+			if (vertices.size() + static_cast<std::size_t>(fresh) > max_vertices) { continue; }
+			emitted[triangle] = true;
+			++triangles;
+			for (auto const vertex : corners) {
+				out.push_back(vertex);
+				if (owner[vertex] == id) { continue; }
+				owner[vertex] = id;
+				vertices.push_back(vertex);
+				for (auto const adjacent : adjacency.of(vertex)) {
+					if (!emitted[adjacent]) { queue.push_back(adjacent); }
+				}
+			}
+		}
+		auto const range = IndexRange{first_index, static_cast<std::uint32_t>(out.size()) - first_index};
+		ret.push_back(make_meshlet(out_geometry.positions, out, vertices, range));
+	}
+
+	out_geometry.indices = Geometry::Packed::Indices::make(out, vertex_count);
+	return ret;
+}
+
+Frustum Frustum::make(glm::mat4x4 const& mat) {
+	auto const row = [&mat](int r) { return glm::vec4{mat[0][r], mat[1][r], mat[2][r], mat[3][r]}; };
+	auto ret = Frustum{};
+	// clip space depth is [0, 1] (GLM_FORCE_DEPTH_ZERO_TO_ONE)
+	ret.planes = {
+		row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(2), row(3) - row(2),
+	};
+	for (auto& plane : ret.planes) {
+		if (auto const length = glm::length(glm::vec3{plane}); length > 0.0f) { plane /= length; }
+	}
+	return ret;
+}
+
+bool Frustum::intersects(glm::vec3 const& centre, float radius) const {
+	return std::all_of(planes.begin(), planes.end(), [&](glm::vec4 const& plane) { return glm::dot(glm::vec3{plane}, centre) + plane.w >= -radius; });
+}
+
+MeshletCuller::MeshletCuller(glm::mat4x4 const& view_proj, glm::vec3 const& camera, bool backface)
+	: m_view_proj(view_proj), m_camera(camera), m_backface(backface) {}
+
+std::uint32_t MeshletCuller::operator()(std::vector<IndexRange>& out_ranges, std::span<Meshlet const> meshlets, std::span<glm::mat4x4 const> instances) {
+	// transform the view into each instance's local space instead of transforming every meshlet's bounds
+	m_views.clear();
+	m_views.reserve(instances.size());
+	for (auto const& model : instances) {
+		auto view = View{.frustum = Frustum::make(m_view_proj * model)};
+		// mirrored instances flip winding, skip cone culling for them
+		view.backface = m_backface && glm::determinant(glm::mat3x3{model}) > 0.0f;
+		if (view.backface) { view.camera = glm::vec3{glm::inverse(model) * glm::vec4{m_camera, 1.0f}}; }
+		m_views.push_back(view);
+	}
+
+	auto const visible = [this](Meshlet const& meshlet) {
+		auto const visible_in = [&meshlet](View const& view) {
+			if (!view.frustum.intersects(meshlet.centre, meshlet.radius)) { return false; }
+			return !view.backface || !meshlet.backfacing(view.camera);
+		};
+		return std::any_of(m_views.begin(), m_views.end(), visible_in);
+	};
+
+	auto ret = std::uint32_t{};
+	for (auto const& meshlet : meshlets) {
+		if (!visible(meshlet)) {
+			++ret;
+			continue;
+		}
+		// meshlets are contiguous in the index buffer: merge adjacent survivors into a single draw
+		if (!out_ranges.empty() && out_ranges.back().first_index + out_ranges.back().index_count == meshlet.indices.first_index) {
+			out_ranges.back().index_count += meshlet.indices.index_count;
+		} else {
+			out_ranges.push_back(meshlet.indices);
+		}
+	}
+	return ret;
+}
+} // namespace facade
@@ -1,11 +1,19 @@
+#include <facade/util/enumerate.hpp>
+#include <facade/util/error.hpp>
 #include <facade/util/logger.hpp>
 #include <facade/vk/cmd.hpp>
 #include <facade/vk/texture.hpp>
+#include <atomic>
 #include <cmath>
+#include <mutex>
 #include <numeric>
+#include <optional>
 
 namespace facade {
 namespace {
+// levels larger than this are streamed in after construction
+constexpr std::uint32_t stream_extent_v{64};
+
 ImageBarrier full_barrier(ImageView const& image, std::uint32_t levels, std::uint32_t layers, vk::ImageLayout const src, vk::ImageLayout const dst) {
 	auto ret = ImageBarrier{};
 	ret.barrier.srcAccessMask = ret.barrier.dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite;
@@ -82,16 +90,65 @@ struct MipMapWriter {
 	}
 };
 
+// {unorm, srgb}
+constexpr Pair<vk::Format> compressed_format_pairs_v[] = {
+	// uncompressed KTX2 payloads (cooked scenes)
+	{vk::Format::eR8G8B8A8Unorm, vk::Format::eR8G8B8A8Srgb},
+	{vk::Format::eBc1RgbUnormBlock, vk::Format::eBc1RgbSrgbBlock},
+	{vk::Format::eBc1RgbaUnormBlock, vk::Format::eBc1RgbaSrgbBlock},
+	{vk::Format::eBc2UnormBlock, vk::Format::eBc2SrgbBlock},
+	{vk::Format::eBc3UnormBlock, vk::Format::eBc3SrgbBlock},
+	{vk::Format::eBc7UnormBlock, vk::Format::eBc7SrgbBlock},
+	{vk::Format::eEtc2R8G8B8UnormBlock, vk::Format::eEtc2R8G8B8SrgbBlock},
+	{vk::Format::eEtc2R8G8B8A1UnormBlock, vk::Format::eEtc2R8G8B8A1SrgbBlock},
+	{vk::Format::eEtc2R8G8B8A8UnormBlock, vk::Format::eEtc2R8G8B8A8SrgbBlock},
+	{vk::Format::eAstc4x4UnormBlock, vk::Format::eAstc4x4SrgbBlock},
+};
+
+// formats without an sRGB variant (BC4 / BC5 / BC6H) are left untouched
+constexpr vk::Format with_colour_space(vk::Format format, ColourSpace colour_space) {
+	for (auto const& [unorm, srgb] : compressed_format_pairs_v) {
+		if (format == unorm || format == srgb) { return colour_space == ColourSpace::eLinear ? unorm : srgb; }
+	}
+	return format;
+}
+
+constexpr vk::ComponentSwizzle to_component_swizzle(char const channel) {
+	switch (channel) {
+	case 'r': return vk::ComponentSwizzle::eR;
+	case 'g': return vk::ComponentSwizzle::eG;
+	case 'b': return vk::ComponentSwizzle::eB;
+	case 'a': return vk::ComponentSwizzle::eA;
+	case '0': return vk::ComponentSwizzle::eZero;
+	case '1': return vk::ComponentSwizzle::eOne;
+	default: return vk::ComponentSwizzle::eIdentity;
+	}
+}
+
 bool can_mip(vk::PhysicalDevice const gpu, vk::Format const format) {
 	static constexpr vk::FormatFeatureFlags flags_v{vk::FormatFeatureFlagBits::eBlitDst | vk::FormatFeatureFlagBits::eBlitSrc};
 	auto const fsrc = gpu.getFormatProperties(format);
 	return (fsrc.optimalTilingFeatures & flags_v) != vk::FormatFeatureFlags{};
 }
 
-Defer<UniqueImage> make_image(Gfx const& gfx, std::span<Image::View const> images, ImageCreateInfo const& info, vk::ImageViewType type) {
-	auto const extent = vk::Extent2D{images[0].extent.x, images[0].extent.y};
+// staging contains tightly packed RGBA data for all layers of level 0, other levels are blitted from it
+Defer<UniqueImage> make_image(Gfx const& gfx, vk::Buffer staging, vk::Extent2D extent, ImageCreateInfo const& info, vk::ImageViewType type) {
 	auto ret = Defer<UniqueImage>{gfx.vma.make_image(info, extent, type), gfx.shared->defer_queue};
+	auto isrl = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, info.array_layers);
+	auto icr = vk::ImageCopy(isrl, {}, isrl, {}, vk::Extent3D{extent, 1});
+	auto bic = vk::BufferImageCopy({}, {}, {}, isrl, {}, icr.extent);
+	auto cmd = Cmd{gfx};
+	full_barrier(ret.get().get().image_view(), info.mip_levels, info.array_layers, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal)
+		.transition(cmd.cb);
+	cmd.cb.copyBufferToImage(staging, ret.get().get().image, vk::ImageLayout::eTransferDstOptimal, bic);
+	full_barrier(ret.get().get().image_view(), info.mip_levels, info.array_layers, vk::ImageLayout::eTransferDstOptimal,
+				 vk::ImageLayout::eShaderReadOnlyOptimal)
+		.transition(cmd.cb);
+	if (info.mip_levels > 1) { MipMapWriter{ret.get().get().image, ret.get().get().extent, cmd.cb, info.mip_levels}(); }
+	return ret;
+}
 
+Defer<UniqueImage> make_image(Gfx const& gfx, std::span<Image::View const> images, ImageCreateInfo const& info, vk::ImageViewType type) {
 	auto const accumulate_size = [](std::size_t total, Image::View const& i) { return total + i.bytes.size(); };
 	auto const size = std::accumulate(images.begin(), images.end(), std::size_t{}, accumulate_size);
 	auto staging = gfx.vma.make_buffer(vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst, size, true);
@@ -105,22 +162,76 @@ Defer<UniqueImage> make_image(Gfx const& gfx, std::span<Image::View const> image
 		std::memcpy(ptr, image.bytes.data(), image.bytes.size());
 		ptr += image.bytes.size();
 	}
+	return make_image(gfx, staging.get().buffer, vk::Extent2D{images[0].extent.x, images[0].extent.y}, info, type);
+}
+Defer<UniqueImage> make_image(Gfx const& gfx, std::span<CompressedImage::Level const> levels, ImageCreateInfo const& info) {
+	// buffer offsets must be multiples of the texel block size (at most 16 bytes for supported formats)
+	static constexpr std::size_t align_v{16};
+	auto const aligned = [](std::size_t size) { return (size + align_v - 1) & ~(align_v - 1); };
+	auto const extent = vk::Extent2D{levels[0].extent.x, levels[0].extent.y};
+	auto ret = Defer<UniqueImage>{gfx.vma.make_image(info, extent, vk::ImageViewType::e2D), gfx.shared->defer_queue};
+
+	auto const accumulate_size = [aligned](std::size_t total, CompressedImage::Level const& l) { return total + aligned(l.bytes.size()); };
+	auto const size = std::accumulate(levels.begin(), levels.end(), std::size_t{}, accumulate_size);
+	auto staging = gfx.vma.make_buffer(vk::BufferUsageFlagBits::eTransferSrc, size, true);
+	if (!staging.get().buffer) { return {}; }
+
+	auto bics = std::vector<vk::BufferImageCopy>{};
+	bics.reserve(levels.size());
+	auto offset = std::size_t{};
+	for (auto const [level, mip] : enumerate(levels)) {
+		std::memcpy(static_cast<std::byte*>(staging.get().ptr) + offset, level.bytes.data(), level.bytes.size());
+		auto const isrl = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, static_cast<std::uint32_t>(mip), 0, 1);
+		bics.push_back(vk::BufferImageCopy(offset, {}, {}, isrl, {}, vk::Extent3D{level.extent.x, level.extent.y, 1}));
+		offset += aligned(level.bytes.size());
+	}
 
-	auto isrl = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, info.array_layers);
-	auto icr = vk::ImageCopy(isrl, {}, isrl, {}, vk::Extent3D{extent, 1});
-	auto bic = vk::BufferImageCopy({}, {}, {}, isrl, {}, icr.extent);
 	auto cmd = Cmd{gfx};
-	full_barrier(ret.get().get().image_view(), info.mip_levels, info.array_layers, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal)
-		.transition(cmd.cb);
-	cmd.cb.copyBufferToImage(staging.get().buffer, ret.get().get().image, vk::ImageLayout::eTransferDstOptimal, bic);
-	full_barrier(ret.get().get().image_view(), info.mip_levels, info.array_layers, vk::ImageLayout::eTransferDstOptimal,
-				 vk::ImageLayout::eShaderReadOnlyOptimal)
-		.transition(cmd.cb);
-	if (info.mip_levels > 1) { MipMapWriter{ret.get().get().image, ret.get().get().extent, cmd.cb, info.mip_levels}(); }
+	auto const& image = ret.get().get();
+	full_barrier(image.image_view(), info.mip_levels, 1, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal).transition(cmd.cb);
+	cmd.cb.copyBufferToImage(staging.get().buffer, image.image, vk::ImageLayout::eTransferDstOptimal, bics);
+	full_barrier(image.image_view(), info.mip_levels, 1, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal).transition(cmd.cb);
+	return ret;
+}
+
+ImageCreateInfo make_image_info(Gfx const& gfx, CompressedImage::View image, TextureCreateInfo const& info) {
+	if (!Texture::is_supported(gfx, image)) {
+		throw Error{fmt::format("Unsupported compressed texture format: [{}]", vk::to_string(static_cast<vk::Format>(image.vk_format)))};
+	}
+	auto ret = ImageCreateInfo{};
+	ret.format = with_colour_space(static_cast<vk::Format>(image.vk_format), info.colour_space);
+	// mip levels are pre-built, block compressed formats cannot be blitted
+	ret.mip_levels = info.mip_mapped ? static_cast<std::uint32_t>(image.levels.size()) : 1u;
+	ret.usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+	auto const& [r, g, b, a] = image.swizzle;
+	ret.components = vk::ComponentMapping{to_component_swizzle(r), to_component_swizzle(g), to_component_swizzle(b), to_component_swizzle(a)};
 	return ret;
 }
+
+std::uint32_t first_resident_level(std::span<CompressedImage::Level const> levels) {
+	for (auto const [level, index] : enumerate(levels)) {
+		if (std::max(level.extent.x, level.extent.y) <= stream_extent_v) { return static_cast<std::uint32_t>(index); }
+	}
+	return static_cast<std::uint32_t>(levels.size() - 1);
+}
 } // namespace
 
+StagedImage::StagedImage(Gfx const& gfx, std::span<std::byte const> compressed, std::string name) : m_name(std::move(name)) {
+	auto const extent = Image::peek(compressed);
+	if (extent.x == 0 || extent.y == 0) {
+		logger::warn("[StagedImage] Unsupported image: [{}]", m_name);
+		return;
+	}
+	auto const size = std::size_t{extent.x} * std::size_t{extent.y} * 4;
+	auto buffer = gfx.vma.make_buffer(vk::BufferUsageFlagBits::eTransferSrc, size, true);
+	if (!buffer.get().buffer || !Image::decode(compressed, {static_cast<std::byte*>(buffer.get().ptr), size})) {
+		logger::warn("[StagedImage] Failed to decode image: [{}]", m_name);
+		return;
+	}
+	m_buffer = std::move(buffer);
+	m_extent = extent;
+}
+
 Sampler::Sampler(Gfx const& gfx, CreateInfo info) {
 	auto sci = vk::SamplerCreateInfo{};
 	sci.minFilter = info.min;
@@ -158,6 +269,108 @@ Texture::Texture(Gfx const& gfx, vk::Sampler sampler, Image::View image, CreateI
 	m_layout = vk::ImageLayout::eShaderReadOnlyOptimal;
 }
 
+Texture::Texture(Gfx const& gfx, vk::Sampler sampler, StagedImage const& image, CreateInfo info) : Texture(gfx, sampler, std::move(info.name)) {
+	if (!image) { throw Error{fmt::format("Invalid staged image: [{}]", image.name())}; }
+	m_info.format = info.colour_space == ColourSpace::eLinear ? vk::Format::eR8G8B8A8Unorm : vk::Format::eR8G8B8A8Srgb;
+	auto const extent = vk::Extent2D{image.extent().x, image.extent().y};
+	if (info.mip_mapped && can_mip(m_gfx.gpu, m_info.format)) { m_info.mip_levels = mip_levels(extent); }
+	m_image = make_image(m_gfx, image.buffer(), extent, m_info, vk::ImageViewType::e2D);
+	m_layout = vk::ImageLayout::eShaderReadOnlyOptimal;
+}
+
+bool Texture::is_supported(Gfx const& gfx, vk::Format format) {
+	auto const props = gfx.gpu.getFormatProperties(format);
+	return (props.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage) == vk::FormatFeatureFlagBits::eSampledImage;
+}
+
+bool Texture::is_supported(Gfx const& gfx, CompressedImage::View image) {
+	return !image.levels.empty() && is_supported(gfx, static_cast<vk::Format>(image.vk_format));
+}
+
+Texture::Texture(Gfx const& gfx, vk::Sampler sampler, CompressedImage::View image, CreateInfo info) : Texture(gfx, sampler, std::move(info.name)) {
+	m_info = make_image_info(m_gfx, image, info);
+	m_image = make_image(m_gfx, image.levels.first(m_info.mip_levels), m_info);
+	m_layout = vk::ImageLayout::eShaderReadOnlyOptimal;
+}
+
+struct Texture::Stream {
+	struct Ready {
+		Defer<UniqueImage> image{};
+		std::uint32_t level{};
+	};
+
+	Gfx gfx{};
+	std::shared_ptr<CompressedImage const> source{};
+	ImageCreateInfo info{};
+	// least detailed level the image is ever reduced to
+	std::uint32_t floor{};
+
+	std::atomic<bool> busy{};
+	std::mutex mutex{};
+	std::optional<Ready> ready{};
+
+	// render thread only: most detailed level in the bound image
+	std::uint32_t level{};
+
+	// (re)build an image containing all levels from level onwards
+	Defer<UniqueImage> build(std::uint32_t const level) const {
+		auto image_info = info;
+		image_info.mip_levels = info.mip_levels - level;
+		return make_image(gfx, source->view().levels.subspan(level, image_info.mip_levels), image_info);
+	}
+};
+
+Texture::Texture(Gfx const& gfx, vk::Sampler sampler, std::shared_ptr<CompressedImage const> image, CreateInfo info)
+	: Texture(gfx, sampler, std::move(info.name)) {
+	assert(image);
+	auto const view = image->view();
+	m_info = make_image_info(m_gfx, view, info);
+	m_layout = vk::ImageLayout::eShaderReadOnlyOptimal;
+	auto const floor = first_resident_level(view.levels.first(m_info.mip_levels));
+	if (!info.stream || floor == 0) {
+		m_image = make_image(m_gfx, view.levels.first(m_info.mip_levels), m_info);
+		return;
+	}
+	m_stream = std::make_shared<Stream>();
+	m_stream->gfx = m_gfx;
+	m_stream->source = std::move(image);
+	m_stream->info = m_info;
+	m_stream->floor = m_stream->level = floor;
+	m_image = m_stream->build(floor);
+}
+
+bool Texture::streaming() const { return m_stream && m_stream->level > 0; }
+
+std::uint32_t Texture::resident_level() const { return m_stream ? m_stream->level : 0; }
+
+std::uint32_t Texture::evictable_levels() const { return m_stream ? m_stream->floor - m_stream->level : 0; }
+
+UniqueTask<void()> Texture::stream_to(std::uint32_t const level) {
+	if (!m_stream || level > m_stream->floor || level == m_stream->level || m_stream->busy.exchange(true)) { return {}; }
+	return [stream = m_stream, level] {
+		auto image = stream->build(level);
+		auto lock = std::scoped_lock{stream->mutex};
+		if (image.get().get().image) { stream->ready.emplace(Stream::Ready{std::move(image), level}); }
+		stream->busy = false;
+	};
+}
+
+UniqueTask<void()> Texture::stream_next() {
+	if (!streaming()) { return {}; }
+	return stream_to(m_stream->level - 1);
+}
+
+bool Texture::update_stream() {
+	if (!m_stream) { return false; }
+	auto lock = std::scoped_lock{m_stream->mutex};
+	if (!m_stream->ready) { return false; }
+	// the previous image is destroyed once frames in flight are done with it
+	m_image = std::move(m_stream->ready->image);
+	m_stream->level = m_stream->ready->level;
+	m_stream->ready.reset();
+	return true;
+}
+
 Texture::Texture(Gfx const& gfx, vk::Sampler sampler, std::string name) : sampler(sampler), m_gfx(gfx), m_name(std::move(name)) {}
 
 Cubemap::Cubemap(Gfx const& gfx, vk::Sampler sampler, std::span<Image::View const> images, std::string name) : Texture(gfx, sampler, std::move(name)) {
@@ -52,19 +52,22 @@ UniqueImage Vma::make_image(ImageCreateInfo const& info, vk::Extent2D const exte
 	auto const vici = static_cast<VkImageCreateInfo>(ici);
 	auto image = VkImage{};
 	auto ret = Image{};
-	if (vmaCreateImage(allocator, &vici, &vaci, &image, &ret.allocation.allocation, {}) != VK_SUCCESS) { throw Error{"Failed to allocate Vulkan Image"}; }
-	ret.view = make_image_view(image, info.format, {info.aspect, 0, info.mip_levels, 0, info.array_layers}, type);
+	auto vai = VmaAllocationInfo{};
+	if (vmaCreateImage(allocator, &vici, &vaci, &image, &ret.allocation.allocation, &vai) != VK_SUCCESS) { throw Error{"Failed to allocate Vulkan Image"}; }
+	ret.view = make_image_view(image, info.format, {info.aspect, 0, info.mip_levels, 0, info.array_layers}, type, info.components);
 	ret.image = image;
 	ret.allocation.vma = *this;
 	ret.extent = extent;
+	ret.size = vai.size;
 	return UniqueImage{std::move(ret)};
 }
 
-vk::UniqueImageView Vma::make_image_view(vk::Image const image, vk::Format const format, vk::ImageSubresourceRange isr, vk::ImageViewType type) const {
+vk::UniqueImageView Vma::make_image_view(vk::Image const image, vk::Format const format, vk::ImageSubresourceRange isr, vk::ImageViewType type,
+										 vk::ComponentMapping components) const {
 	vk::ImageViewCreateInfo info;
 	info.viewType = type;
 	info.format = format;
-	info.components.r = info.components.g = info.components.b = info.components.a = vk::ComponentSwizzle::eIdentity;
+	info.components = components;
 	info.subresourceRange = isr;
 	info.image = image;
 	return device.createImageViewUnique(info);
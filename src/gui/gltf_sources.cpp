@@ -25,7 +25,7 @@ fs::path find_file_with_ext(fs::path root, env::MatchList exts) {
 
 FileBrowser::FileBrowser(std::shared_ptr<Events> const& events, std::string browse_path)
 	: m_events(events), m_observer(events, [this](event::OpenFile) { m_trigger = true; }),
-	  m_browser("Browse...", {".gltf", ".skybox"}, std::move(browse_path)) {}
+	  m_browser("Browse...", {".gltf", ".glb", ".fcs", ".fpk", ".skybox"}, std::move(browse_path)) {}
 
 std::string FileBrowser::update() {
 	auto result = m_browser.update(m_trigger);
@@ -43,12 +43,12 @@ DropFile::DropFile(std::shared_ptr<Events> const& events) : m_observer(events, [
 
 std::string DropFile::update() {
 	if (m_path.empty()) { return {}; }
-	static constexpr std::string_view exts_v[] = {".gltf", ".skybox"};
+	static constexpr std::string_view exts_v[] = {".gltf", ".glb", ".fcs", ".fpk", ".skybox"};
 	if (auto ret = find_file_with_ext(m_path, exts_v); fs::is_regular_file(ret)) {
 		m_path.clear();
 		return ret.generic_string();
 	}
-	logger::error("Failed to locate .gltf / .skybox in path: [{}]", m_path);
+	logger::error("Failed to locate .gltf / .glb / .fcs / .fpk / .skybox in path: [{}]", m_path);
 	m_path.clear();
 	return {};
 }
@@ -86,6 +86,9 @@ bool WindowMenu::display_stats(Engine& engine) {
 		ImGui::Text("%s", FixedString{"Counter: {}", stats.frame_counter}.c_str());
 		ImGui::Text("%s", FixedString{"Triangles: {}", stats.triangles}.c_str());
 		ImGui::Text("%s", FixedString{"Draw calls: {}", stats.draw_calls}.c_str());
+		ImGui::Text("%s", FixedString{"Meshlets culled: {}", stats.meshlets_culled}.c_str());
+		ImGui::Text("%s", FixedString{"Textures streaming: {}", stats.textures_streaming}.c_str());
+		ImGui::Text("%s", FixedString{"Texture memory: {:.1f}MiB", static_cast<double>(stats.texture_memory) / (1024.0 * 1024.0)}.c_str());
 		ImGui::Text("%s", FixedString{"FPS: {}", (stats.fps == 0 ? static_cast<std::uint32_t>(stats.frame_counter) : stats.fps)}.c_str());
 		ImGui::Text("%s", FixedString{"Frame time: {:.2f}ms", engine.state().dt * 1000.0f}.c_str());
 		ImGui::Text("%s", FixedString{"MSAA: {}x", to_int(stats.current_msaa)}.c_str());
@@ -101,6 +104,11 @@ bool WindowMenu::display_stats(Engine& engine) {
 			ImGui::SameLine();
 			ImGui::DragFloat("Line Width", &ps.line_width, 0.1f, 1.0f, 10.0f);
 		}
+		ImGui::Checkbox("Cull meshlets", &ps.frustum_cull);
+		if (ps.frustum_cull) {
+			ImGui::SameLine();
+			ImGui::Checkbox("Backfaces", &ps.backface_cull);
+		}
 	}
 	return show;
 }
@@ -111,10 +119,7 @@ bool WindowMenu::display_log() {
 	static auto const size = ImVec2{0.5f * (ImGui::GetMainViewport()->Size.x - extent_v.x), (ImGui::GetMainViewport()->Size.y - extent_v.y - 20.0f)};
 	ImGui::SetNextWindowPos(size, ImGuiCond_Once);
 	ImGui::SetNextWindowSize(extent_v, ImGuiCond_Once);
-	if (auto window = editor::Window{"Log", &show}) {
-		logger::access_buffer(*this);
-		editor::display_log(window, m_data.log_state);
-	}
+	if (auto window = editor::Window{"Log", &show}) { editor::display_log(window, m_data.log_state); }
 	return show;
 }
 
@@ -142,14 +147,6 @@ void WindowMenu::change_vsync(Engine const& engine) const {
 	logger::info("Requesting present mode: [{}]", present_mode_str(next_mode));
 }
 
-void WindowMenu::operator()(std::span<logger::Entry const> entries) {
-	m_data.log_state.list.clear();
-	for (auto const& entry : entries) {
-		if (!m_data.log_state.level_filter[entry.level]) { continue; }
-		m_data.log_state.list.push_back(&entry);
-	}
-}
-
 void FileMenu::add_recent(std::string path) {
 	if (auto it = std::find(m_recents.begin(), m_recents.end(), path); it != m_recents.end()) { m_recents.erase(it); }
 	m_recents.push_back(std::move(path));
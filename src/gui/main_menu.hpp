@@ -25,7 +25,7 @@ class FileMenu {
 	std::vector<std::string> m_recents;
 };
 
-class WindowMenu : public logger::Accessor {
+class WindowMenu {
   public:
 	void display_menu(editor::NotClosed<editor::MainMenu> main);
 	void display_windows(Engine& engine);
@@ -41,8 +41,6 @@ class WindowMenu : public logger::Accessor {
 
 	void change_vsync(Engine const& engine) const;
 
-	void operator()(std::span<logger::Entry const> entries) final;
-
 	struct {
 		editor::LogState log_state{};
 		editor::InspectNode inspect{};
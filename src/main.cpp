@@ -4,10 +4,15 @@
 #include <facade/util/data_provider.hpp>
 #include <facade/util/error.hpp>
 #include <facade/util/logger.hpp>
+#include <facade/util/thread_pool.hpp>
+#include <facade/util/time.hpp>
 
 #include <facade/vk/geometry.hpp>
 
+#include <facade/scene/cooked_scene.hpp>
 #include <facade/scene/fly_cam.hpp>
+#include <facade/scene/glb.hpp>
+#include <facade/scene/gltf_loader.hpp>
 
 #include <facade/engine/editor/browse_file.hpp>
 #include <facade/engine/engine.hpp>
@@ -43,8 +48,34 @@ void log_prologue() {
 
 struct AppOpts {
 	std::optional<std::uint32_t> force_threads{};
+	LoadOptions load_options{};
+	std::uint64_t texture_budget{};
+	std::string cook_path{};
 };
 
+bool cook(AppOpts const& opts) {
+	auto const out_path = fs::path{opts.cook_path}.replace_extension(CookedScene::extension_v).string();
+	auto const start = time::since_start();
+	auto thread_pool = ThreadPool{opts.force_threads};
+	auto const cook_json = [&](dj::Json const& json, DataProvider const& provider) {
+		auto const stamp = Scene::GltfLoader::source_stamp(opts.cook_path.c_str(), json, opts.load_options);
+		return Scene::GltfLoader::cook(out_path.c_str(), json, provider, opts.load_options, &thread_pool, stamp);
+	};
+	auto cooked = bool{};
+	if (fs::path{opts.cook_path}.extension() == GlbDataProvider::extension_v) {
+		auto const provider = GlbDataProvider{opts.cook_path.c_str()};
+		cooked = provider && cook_json(provider.json(), provider);
+	} else {
+		cooked = cook_json(dj::Json::from_file(opts.cook_path.c_str()), FileDataProvider::mount_parent_dir(opts.cook_path.c_str()));
+	}
+	if (!cooked) {
+		logger::error("Failed to cook GLTF: [{}]", opts.cook_path);
+		return false;
+	}
+	logger::info("Cooked [{}] => [{}] in [{:.2f}s]", opts.cook_path, out_path, time::since_start() - start);
+	return true;
+}
+
 void run(AppOpts const& opts) {
 	auto events = std::make_shared<Events>();
 	auto engine = std::optional<Engine>{};
@@ -53,6 +84,8 @@ void run(AppOpts const& opts) {
 	engine_info.extent = config.config.window.extent;
 	engine_info.desired_msaa = config.config.window.msaa;
 	engine_info.force_thread_count = opts.force_threads;
+	engine_info.load_options = opts.load_options;
+	engine_info.texture_budget = opts.texture_budget;
 
 	auto node_id = Id<Node>{};
 	auto post_scene_load = [&engine, &node_id]() {
@@ -184,6 +217,19 @@ std::optional<std::uint32_t> to_u32(std::string_view const s) {
 	}
 	return ret;
 }
+
+std::optional<logger::Level> to_level(std::string_view const s) {
+	static constexpr std::string_view names_v[] = {"error", "warn", "info", "debug"};
+	for (std::size_t i = 0; i < std::size(names_v); ++i) {
+		if (s == names_v[i]) { return static_cast<logger::Level>(i); }
+	}
+	logger::error("Invalid log level: {}", s);
+	return {};
+}
+
+void set_log_level(logger::Level const level) {
+	for (auto const sink : {logger::Sink::eConsole, logger::Sink::eFile, logger::Sink::eBuffer}) { logger::set_level(sink, level); }
+}
 } // namespace
 
 int main(int argc, char** argv) {
@@ -195,6 +241,24 @@ int main(int argc, char** argv) {
 			void opt(CliOpts::Key key, CliOpts::Value value) final {
 				switch (key.single) {
 				case 't': app_opts.force_threads = to_u32(std::string{value}); return;
+				case 'w': app_opts.load_options.weld_vertices = true; return;
+				case 'o': app_opts.load_options.optimize_meshes = true; return;
+				case 'm': app_opts.load_options.build_meshlets = false; return;
+				case 'c':
+					app_opts.load_options.compress_textures = true;
+					app_opts.load_options.texture_cache = value;
+					return;
+				case 's': app_opts.load_options.stream_textures = true; return;
+				case 'b':
+					// evicting requires streamed textures
+					app_opts.load_options.stream_textures = true;
+					app_opts.texture_budget = std::uint64_t{to_u32(std::string{value}).value_or(0)} * 1024 * 1024;
+					return;
+				case 'k': app_opts.cook_path = value; return;
+				case 'l': app_opts.load_options.cook_scenes = true; return;
+				case 'v':
+					if (auto const level = to_level(value)) { set_log_level(*level); }
+					return;
 				default: break;
 				}
 			}
@@ -207,6 +271,50 @@ int main(int argc, char** argv) {
 				.is_optional_value = false,
 				.help = "Force number of loading threads",
 			},
+			CliOpts::Opt{
+				.key = CliOpts::Key{.full = "weld-vertices", .single = 'w'},
+				.help = "Merge duplicate vertices of loaded meshes",
+			},
+			CliOpts::Opt{
+				.key = CliOpts::Key{.full = "optimize-meshes", .single = 'o'},
+				.help = "Reorder loaded meshes for vertex cache / overdraw / fetch efficiency",
+			},
+			CliOpts::Opt{
+				.key = CliOpts::Key{.full = "no-meshlets", .single = 'm'},
+				.help = "Do not split large loaded meshes into meshlets for view culling",
+			},
+			CliOpts::Opt{
+				.key = CliOpts::Key{.full = "compress-textures", .single = 'c'},
+				.value = "CACHE_DIR",
+				.is_optional_value = true,
+				.help = "Encode loaded textures as BC7 / BC5 (cached in CACHE_DIR if set)",
+			},
+			CliOpts::Opt{
+				.key = CliOpts::Key{.full = "stream-textures", .single = 's'},
+				.help = "Stream in mip levels of compressed textures after loading",
+			},
+			CliOpts::Opt{
+				.key = CliOpts::Key{.full = "texture-budget", .single = 'b'},
+				.value = "MIB",
+				.is_optional_value = false,
+				.help = "Evict unused mip levels of streamed textures to stay within MIB of texture memory",
+			},
+			CliOpts::Opt{
+				.key = CliOpts::Key{.full = "cook", .single = 'k'},
+				.value = "GLTF_PATH",
+				.is_optional_value = false,
+				.help = "Cook GLTF_PATH (.gltf / .glb) into a .fcs scene next to it and exit",
+			},
+			CliOpts::Opt{
+				.key = CliOpts::Key{.full = "cook-on-load", .single = 'l'},
+				.help = "Cook loaded GLTF assets into .fcs scenes, and load those while up to date",
+			},
+			CliOpts::Opt{
+				.key = CliOpts::Key{.full = "log-level", .single = 'v'},
+				.value = "LEVEL",
+				.is_optional_value = false,
+				.help = "Most verbose level to log (error / warn / info / debug): messages above it are not formatted",
+			},
 		};
 		spec.version = version_string();
 		auto parser = Parser{};
@@ -216,6 +324,7 @@ int main(int argc, char** argv) {
 		case CliOpts::Result::eContinue: break;
 		}
 		try {
+			if (!parser.app_opts.cook_path.empty()) { return cook(parser.app_opts) ? EXIT_SUCCESS : EXIT_FAILURE; }
 			run(parser.app_opts);
 		} catch (InitError const& e) {
 			logger::error("Initialization failure: {}", e.what());
@@ -0,0 +1,84 @@
+#include <facade/util/data_provider.hpp>
+#include <facade/util/pack_file.hpp>
+#include <fmt/format.h>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+namespace fs = std::filesystem;
+using namespace facade;
+
+// cooked scenes are outputs too (the scene library is not linked)
+constexpr std::string_view cooked_extension_v{".fcs"};
+
+bool is_output(fs::path const& path) {
+	auto const extension = path.extension();
+	return extension == PackFile::extension_v || extension == cooked_extension_v;
+}
+
+struct Args {
+	fs::path gltf{};
+	fs::path out{};
+	PackFile::Compression compression{PackFile::Compression::eNone};
+};
+
+Args parse(int argc, char const* const argv[]) {
+	auto const exe = fs::path{argv[0]}.filename().generic_string();
+	auto ret = Args{};
+	auto positional = std::vector<std::string_view>{};
+	for (int i = 1; i < argc; ++i) {
+		auto const arg = std::string_view{argv[i]};
+		if (arg == "--lz4") {
+			ret.compression = PackFile::Compression::eLz4;
+		} else {
+			positional.push_back(arg);
+		}
+	}
+	if (positional.empty() || positional.size() > 2) {
+		std::cerr << "Usage: " << exe << " [--lz4] <gltf> [output]\n";
+		throw std::runtime_error{"invalid arguments"};
+	}
+	ret.gltf = positional[0];
+	ret.out = positional.size() > 1 ? fs::path{positional[1]} : fs::path{ret.gltf}.replace_extension(PackFile::extension_v);
+	return ret;
+}
+
+void run(int argc, char const* const argv[]) {
+	auto const args = parse(argc, argv);
+	if (!fs::is_regular_file(args.gltf)) { throw std::runtime_error{"invalid GLTF path: " + args.gltf.generic_string()}; }
+	auto const root = fs::absolute(args.gltf).parent_path();
+	auto const out = fs::absolute(args.out);
+	auto const provider = FileDataProvider{root.generic_string()};
+	auto writer = PackFile::Writer{};
+	auto total = std::uintmax_t{};
+	auto count = std::size_t{};
+	// every file in the GLTF directory: buffers and images are referenced by relative URIs
+	for (auto const& it : fs::recursive_directory_iterator{root}) {
+		if (!it.is_regular_file() || it.path() == out || is_output(it.path())) { continue; }
+		auto const uri = it.path().lexically_relative(root).generic_string();
+		auto const data = provider.view(uri);
+		if (!data && it.file_size() > 0) { throw std::runtime_error{"failed to read: " + it.path().generic_string()}; }
+		writer.add(uri, data.bytes(), args.compression);
+		total += it.file_size();
+		++count;
+	}
+	writer.set_root(args.gltf.filename().generic_string());
+	if (!writer.write(out.generic_string().c_str())) { throw std::runtime_error{"failed to write: " + out.generic_string()}; }
+	std::cout << fmt::format("Packed {} files ({} bytes) => {} ({} bytes)\n", count, total, out.generic_string(), fs::file_size(out));
+}
+} // namespace
+
+// Syntax: pack-assets [--lz4] <gltf> [output]
+// 	gltf: path to the GLTF JSON, its directory (recursively) is packed
+// 	output: path to the pack file, defaults to the GLTF path with the extension replaced by .fpk
+// 	--lz4: compress entries (that shrink) with LZ4
+int main(int argc, char** argv) {
+	try {
+		run(argc, argv);
+	} catch (std::exception const& e) {
+		std::cerr << "Error: " << e.what() << '\n';
+		return EXIT_FAILURE;
+	}
+}